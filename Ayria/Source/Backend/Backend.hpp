@@ -26,6 +26,9 @@ namespace Backend
     // Add a recurring task to the worker thread.
     void Enqueuetask(uint32_t Period, void(__cdecl *Callback)());
 
+    // One-off jobs for the worker pool, results should be handed back via a recurring task.
+    void Enqueuejob(std::function<void()> &&Job);
+
     // Poll the internal socket(s).
     void Updatenetworking();
 
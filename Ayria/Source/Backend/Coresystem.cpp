@@ -18,6 +18,41 @@ namespace Backend
         Backgroundtasks.push_back({ 0, Period, Callback });
     }
 
+    // Jobs too slow for the background thread, e.g. signature verification.
+    std::queue<std::function<void()>> Pendingjobs;
+    std::condition_variable Jobsignal;
+    std::mutex Joblock;
+
+    void Enqueuejob(std::function<void()> &&Job)
+    {
+        {
+            std::scoped_lock Lock(Joblock);
+            Pendingjobs.push(std::move(Job));
+        }
+        Jobsignal.notify_one();
+    }
+    static DWORD __stdcall Workerthread(void *)
+    {
+        // Name this thread for easier debugging.
+        setThreadname("Ayria_Worker");
+
+        // Main loop, runs until the application terminates or DLL unloads.
+        while (true)
+        {
+            std::function<void()> Job;
+            {
+                std::unique_lock Lock(Joblock);
+                Jobsignal.wait(Lock, [] { return !Pendingjobs.empty(); });
+                Job = std::move(Pendingjobs.front());
+                Pendingjobs.pop();
+            }
+
+            Job();
+        }
+
+        return 0;
+    }
+
     static DWORD __stdcall Graphicsthread(void *)
     {
         // UI-thread, boost our priority.
@@ -122,5 +157,10 @@ namespace Backend
         // Workers.
         CreateThread(NULL, NULL, Graphicsthread, NULL, STACK_SIZE_PARAM_IS_A_RESERVATION, NULL);
         CreateThread(NULL, NULL, Backgroundthread, NULL, STACK_SIZE_PARAM_IS_A_RESERVATION, NULL);
+
+        // Leave most cores to the game.
+        const auto Workercount = std::clamp(std::thread::hardware_concurrency() / 4, 1U, 4U);
+        for (uint32_t i = 0; i < Workercount; ++i)
+            CreateThread(NULL, NULL, Workerthread, NULL, STACK_SIZE_PARAM_IS_A_RESERVATION, NULL);
     }
 }
@@ -23,15 +23,18 @@ namespace Backend
     }
     void Sendmessage(uint32_t Messagetype, std::string_view JSONString, uint16_t Port)
     {
-        std::string Encoded;
+        const auto isEncoded = Base64::isValid(JSONString);
+        const auto Payloadsize = isEncoded ? JSONString.size() : Base64::Encodesize(JSONString.size());
 
-        // Pre-allocate storage for the message rather than trusting STL.
-        Encoded.reserve((((JSONString.size() + 2) / 3) * 4) + sizeof(uint64_t));
+        // Allocate the full message once and encode directly into it.
+        std::string Encoded(sizeof(uint64_t) + Payloadsize, '\0');
+        const auto Payload = Encoded.data() + sizeof(uint64_t);
 
         // Windows does not like partial messages, so prefix the buffer with ID and type.
-        Encoded.append((char *)&RandomID, sizeof(RandomID));
-        Encoded.append((char *)&Messagetype, sizeof(Messagetype));
-        Encoded.append(Base64::isValid(JSONString) ? JSONString : Base64::Encode(JSONString));
+        std::memcpy(Encoded.data(), &RandomID, sizeof(RandomID));
+        std::memcpy(Encoded.data() + sizeof(RandomID), &Messagetype, sizeof(Messagetype));
+        if (isEncoded) std::memcpy(Payload, JSONString.data(), Payloadsize);
+        else (void)Base64::EncodeInto(JSONString, { Payload, Payloadsize });
 
         // Non-blocking send.
         const auto &[Sendersocket, _, Multicast] = Networkgroups[Port];
@@ -108,13 +111,20 @@ namespace Backend
             // Do we even care for this message?
             if (const auto Result = Callbacks.find(Packet->Messagetype); Result != Callbacks.end())
             {
-                // All messages should be base64.
-                const auto Decoded = Base64::Decode({ Packet->Payload, size_t(Packetlength - sizeof(uint64_t)) });
+                // All messages should be base64, validated while decoding.
+                const std::string_view Payload{ Packet->Payload, size_t(Packetlength - sizeof(uint64_t)) };
+                if (Payload.empty() || Payload.size() % 4) [[unlikely]] continue;
+
+                // Stack allocation, smaller than the packet.
+                const auto Decodedsize = Base64::Decodesize(Payload);
+                const auto Decoded = (char *)alloca(Decodedsize + 1);
+                if (!Base64::DecodeInto(Payload, { Decoded, Decodedsize })) [[unlikely]] continue;
+                Decoded[Decodedsize] = '\0';
 
                 // May have multiple listeners for the same messageID.
                 for (const auto Callback : Result->second)
                 {
-                    Callback(Packet->RandomID, Decoded.c_str());
+                    Callback(Packet->RandomID, Decoded);
                 }
             }
         }
@@ -18,6 +18,15 @@ namespace Clientinfo
         char8_t Username[32];
     };
     #pragma pack(pop)
+
+    // Per-client AES-GCM channel derived via ECDH, the lock serializes the cipher-contexts.
+    struct Channel_t
+    {
+        Spinlock Lock;
+        AES::GCM Cipher;
+
+        explicit Channel_t(const uint8_t *Key) : Cipher(Key, 32) {}
+    };
     #pragma endregion
 
     // Client core information.
@@ -27,8 +36,12 @@ namespace Clientinfo
     const Networkclient_t *getNetworkclient(uint32_t NodeID);
 
     // Client crypto information.
-    std::string_view getPublickey(uint32_t ClientID);
+    std::string getPublickey(uint32_t ClientID);
+    std::shared_ptr<EVP_PKEY> getParsedkey(uint32_t ClientID);  // The key a client signs with, Ed25519 or RSA.
+    std::shared_ptr<Channel_t> getChannel(uint32_t ClientID);
+    std::shared_ptr<EVP_PKEY> getEncryptionkey(uint32_t ClientID);  // RSA, for clients without a channel.
     std::string_view getHardwarekey();
+    EVP_PKEY *getSigningkey();
     RSA *getSessionkey();
 
     // Initialize the subsystems.
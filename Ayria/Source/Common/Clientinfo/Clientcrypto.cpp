@@ -74,18 +74,59 @@ static inline std::string getHWID()
 
 namespace Clientinfo
 {
-    std::unordered_map<uint32_t, std::string> Publickeys;
+    std::unordered_map<uint32_t, std::shared_ptr<EVP_PKEY>> Parsedkeys, Parsedsigners;
+    std::unordered_map<uint32_t, std::shared_ptr<Channel_t>> Channels;
+    std::unordered_map<uint32_t, std::string> Publickeys, Signingkeys, Exchangekeys;
+    std::unordered_map<uint32_t, std::chrono::steady_clock::time_point> Lastrequests;
+
+    // The maps are updated from the network handler and read from the API / messaging threads.
+    std::mutex Keylock;
     std::string Hardwarekey{};
+    EVP_PKEY *Signingkey{};
+    EC_KEY *Exchangekey{};
     RSA *Sessionkey{};
 
+    // ECDH key for deriving the channels, P-256 to keep the exchange cheap.
+    static EC_KEY *getExchangekey()
+    {
+        if (!Exchangekey) [[unlikely]]
+        {
+            Exchangekey = PK_ECC::Createkeypair(NID_X9_62_prime256v1);
+        }
+
+        return Exchangekey;
+    }
+
     // Requests key from Clients, shares own.
     void Syncpublickeys(std::vector<uint32_t> Clients)
     {
-        // No need to request keys we already have.
-        std::erase_if(Clients, [](const auto &ID) { return Publickeys.contains(ID); });
+        const auto isRequest = !Clients.empty();
+
+        // Older clients never share an exchange-key, so having their RSA key is enough.
+        // Asking again is pointless until the client had time to answer.
+        {
+            std::scoped_lock Guard(Keylock);
+            const auto Now = std::chrono::steady_clock::now();
+
+            std::erase_if(Clients, [&](const auto &ID)
+            {
+                if (Publickeys.contains(ID)) return true;
+
+                const auto Last = Lastrequests.find(ID);
+                if (Last != Lastrequests.end() && Now - Last->second < std::chrono::seconds(10)) return true;
+
+                Lastrequests[ID] = Now;
+                return false;
+            });
+        }
+
+        // Nothing left to ask for.
+        if (isRequest && Clients.empty()) return;
 
         auto Object = nlohmann::json::object();
         Object["Publickey"] = Base64::Encode(PK_RSA::getPublickey(getSessionkey()));
+        Object["Signingkey"] = Base64::Encode(PK_Ed25519::getPublickey(getSigningkey()));
+        Object["Exchangekey"] = Base64::Encode(PK_ECC::getPublickey(getExchangekey()));
         Object["Wantedkeys"] = Clients;
 
         Backend::Sendmessage(Hash::FNV1_32("Syncpublickeys"), Object.dump());
@@ -98,10 +139,70 @@ namespace Clientinfo
 
         const auto Request = ParseJSON(JSONString);
         const auto Publickey = Request.value("Publickey", std::string());
+        const auto Peersigner = Request.value("Signingkey", std::string());
+        const auto Peerkey = Request.value("Exchangekey", std::string());
         const auto Wantedclients = Request.value("Wantedkeys", std::vector<uint32_t>());
 
         if (Publickey.empty()) [[unlikely]] return; // WTF?
-        Publickeys[Client->AccountID.AccountID] = Request["Publickey"];
+
+        {
+            std::scoped_lock Guard(Keylock);
+
+            // Only re-parse when the client has rotated its key.
+            auto &Storedkey = Publickeys[Client->AccountID.AccountID];
+            if (Storedkey != Publickey)
+            {
+                const auto Parsed = PK_RSA::Parsepublickey(Base64::Decode(Publickey));
+                if (!Parsed) [[unlikely]]
+                {
+                    Publickeys.erase(Client->AccountID.AccountID);
+                    Parsedkeys.erase(Client->AccountID.AccountID);
+                    return;
+                }
+
+                Parsedkeys[Client->AccountID.AccountID] = std::shared_ptr<EVP_PKEY>(Parsed, EVP_PKEY_free);
+                Storedkey = Publickey;
+            }
+
+            // Optional, older clients only share RSA. A bad key leaves the client with the RSA scheme.
+            if (const auto Stored = Signingkeys.find(Client->AccountID.AccountID); !Peersigner.empty() && (Stored == Signingkeys.end() || Stored->second != Peersigner))
+            {
+                const auto Parsed = PK_Ed25519::Parsepublickey(Base64::Decode(Peersigner));
+                if (!Parsed) [[unlikely]]
+                {
+                    Debugprint(va("Client %u shared an invalid signing-key.", Client->AccountID.AccountID));
+                    Parsedsigners.erase(Client->AccountID.AccountID);
+                    Signingkeys.erase(Client->AccountID.AccountID);
+                }
+                else
+                {
+                    Parsedsigners[Client->AccountID.AccountID] = std::shared_ptr<EVP_PKEY>(Parsed, EVP_PKEY_free);
+                    Signingkeys[Client->AccountID.AccountID] = Peersigner;
+                }
+            }
+
+            // Derive the channel once per exchange-key rather than per message.
+            auto &Storedexchange = Exchangekeys[Client->AccountID.AccountID];
+            if (!Peerkey.empty() && Storedexchange != Peerkey)
+            {
+                uint8_t Channelkey[32];
+                const auto Parsed = PK_ECC::Parsepublickey(Base64::Decode(Peerkey));
+                const auto isValid = Parsed && PK_ECC::Derivekey(getExchangekey(), Parsed, Channelkey);
+                if (Parsed) EC_KEY_free(Parsed);
+
+                if (isValid)
+                {
+                    Channels[Client->AccountID.AccountID] = std::make_shared<Channel_t>(Channelkey);
+                    OPENSSL_cleanse(Channelkey, sizeof(Channelkey));
+                    Storedexchange = Peerkey;
+                }
+                else
+                {
+                    Channels.erase(Client->AccountID.AccountID);
+                    Exchangekeys.erase(Client->AccountID.AccountID);
+                }
+            }
+        }
 
         const auto Localclient = Clientinfo::getLocalclient();
         for (const auto &wClient : Wantedclients)
@@ -115,14 +216,54 @@ namespace Clientinfo
     }
 
     // Client crypto information.
-    std::string_view getPublickey(uint32_t ClientID)
+    std::string getPublickey(uint32_t ClientID)
+    {
+        {
+            std::scoped_lock Guard(Keylock);
+            if (const auto Result = Publickeys.find(ClientID); Result != Publickeys.end())
+                return Result->second;
+        }
+
+        Syncpublickeys({ ClientID });
+        return {};
+    }
+    std::shared_ptr<EVP_PKEY> getParsedkey(uint32_t ClientID)
+    {
+        {
+            std::scoped_lock Guard(Keylock);
+
+            // Clients sharing an Ed25519 key also sign with it.
+            if (const auto Signer = Parsedsigners.find(ClientID); Signer != Parsedsigners.end())
+                return Signer->second;
+
+            if (const auto Result = Parsedkeys.find(ClientID); Result != Parsedkeys.end())
+                return Result->second;
+        }
+
+        Syncpublickeys({ ClientID });
+        return {};
+    }
+    std::shared_ptr<Channel_t> getChannel(uint32_t ClientID)
     {
-        if (!Publickeys.contains(ClientID))
         {
-            Syncpublickeys({ ClientID });
-            return {};
+            std::scoped_lock Guard(Keylock);
+            if (const auto Result = Channels.find(ClientID); Result != Channels.end())
+                return Result->second;
         }
-        else return Publickeys[ClientID];
+
+        Syncpublickeys({ ClientID });
+        return {};
+    }
+    std::shared_ptr<EVP_PKEY> getEncryptionkey(uint32_t ClientID)
+    {
+        std::scoped_lock Guard(Keylock);
+
+        // Only for clients without a channel, e.g. those that predate the key-exchange.
+        if (Channels.contains(ClientID)) return {};
+        if (const auto Result = Parsedkeys.find(ClientID); Result != Parsedkeys.end())
+            return Result->second;
+
+        return {};
     }
     std::string_view getHardwarekey()
     {
@@ -134,6 +275,15 @@ namespace Clientinfo
 
         return Hardwarekey;
     }
+    EVP_PKEY *getSigningkey()
+    {
+        if (!Signingkey) [[unlikely]]
+        {
+            Signingkey = PK_Ed25519::Createkeypair();
+        }
+
+        return Signingkey;
+    }
     RSA *getSessionkey()
     {
         // Weak key, just for basic privacy.
@@ -148,7 +298,7 @@ namespace Clientinfo
     // Initialize the subsystems.
     void Initialize_crypto()
     {
-        getHardwarekey(); getSessionkey();
+        getHardwarekey(); getSessionkey(); getSigningkey(); getExchangekey();
         Backend::Registermessagehandler(Hash::FNV1_32("Syncpublickeys"), Keysharehandler);
     }
 }
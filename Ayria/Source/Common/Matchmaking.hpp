@@ -17,7 +17,8 @@ namespace Matchmaking
 
         Account_t Hostinfo;
         std::string JSONData; // Keyed by platform, ["Steam"]["Servername"] / ["Demonware"]["SessionID"]
-        std::string Signature;
+        std::string Signature; // RSA, for older clients.
+        std::string Ed25519signature;
     };
 
     // Manage the sessions we know of, updates in the background.
@@ -47,7 +48,8 @@ namespace Matchmaking
                     { "Hostname", Session->Hostinfo.Username.asUTF8() },
                     { "HostID", Session->Hostinfo.ID.Raw },
                     { "Sessiondata", Session->JSONData },
-                    { "Signature", Session->Signature }
+                    { "Signature", Session->Signature },
+                    { "Ed25519signature", Session->Ed25519signature }
                 });
             }
         }
@@ -61,7 +63,8 @@ namespace Matchmaking
                     { "Hostname", Session->Hostinfo.Username.asUTF8() },
                     { "HostID", Session->Hostinfo.ID.Raw },
                     { "Sessiondata", Session->JSONData },
-                    { "Signature", Session->Signature }
+                    { "Signature", Session->Signature },
+                    { "Ed25519signature", Session->Ed25519signature }
                 });
             }
         }
@@ -75,7 +78,8 @@ namespace Matchmaking
                     { "Hostname", Session->Hostinfo.Username.asUTF8() },
                     { "HostID", Session->Hostinfo.ID.Raw },
                     { "Sessiondata", Session->JSONData },
-                    { "Signature", Session->Signature }
+                    { "Signature", Session->Signature },
+                    { "Ed25519signature", Session->Ed25519signature }
                 });
             }
         }
@@ -97,8 +101,9 @@ namespace Matchmaking
         Sessiondata.update(ParseJSON(JSONString));
         Session->JSONData = DumpJSON(Sessiondata);
 
-        // Sign so that others can verify the data.
+        // Sign so that others can verify the data, clients that only share RSA keys can not verify Ed25519.
         Session->Signature = PK_RSA::Signmessage(Session->JSONData, Clientinfo::getSessionkey());
+        Session->Ed25519signature = PK_Signature::Signmessage(Session->JSONData, Clientinfo::getSigningkey());
 
         // Return the session-info in case someone wants it.
         auto Object = nlohmann::json::object({
@@ -106,7 +111,8 @@ namespace Matchmaking
             { "Hostname", Session->Hostinfo.Username.asUTF8() },
             { "HostID", Session->Hostinfo.ID.Raw },
             { "Sessiondata", Session->JSONData },
-            { "Signature", Session->Signature }
+            { "Signature", Session->Signature },
+            { "Ed25519signature", Session->Ed25519signature }
             });
 
         return DumpJSON(Object);
@@ -12,6 +12,23 @@ namespace Matchmaking
     std::vector<Session_t> LANSessions, WANSessions;
     Session_t Localsession{};
 
+    // Hosts re-broadcast the same signed payload, so only verify it once.
+    using Verified_t = struct { uint32_t Lastseen, SenderID; uint64_t HostID; std::string JSONData, Signature; };
+    using Verification_t = struct { uint64_t Payloadhash; bool isValid; uint32_t SenderID; Session_t Session; std::shared_ptr<EVP_PKEY> Publickey; };
+    std::unordered_map<uint64_t, Verified_t> Verifiedpayloads;
+    std::unordered_set<uint64_t> Pendingpayloads;
+    std::vector<Verification_t> Unverified;
+
+    // The signature matching the key the host is known by.
+    static const std::string &Signedwith(const Session_t &Session, EVP_PKEY *Key)
+    {
+        return EVP_PKEY_id(Key) == EVP_PKEY_ED25519 ? Session.Ed25519signature : Session.Signature;
+    }
+
+    // Results from the worker pool.
+    std::vector<Verification_t> Verificationresults;
+    std::mutex Resultlock;
+
     // Manage the sessions we know of, updates in the background.
     std::vector<Session_t *> getLANSessions()
     {
@@ -40,6 +57,7 @@ namespace Matchmaking
         const auto Currenttime = time(NULL);
         std::erase_if(LANSessions, [&](const auto &Session) { return (Session.Lastmessage + 15) < Currenttime; });
         std::erase_if(WANSessions, [&](const auto &Session) { return (Session.Lastmessage + 15) < Currenttime; });
+        std::erase_if(Verifiedpayloads, [&](const auto &Item) { return (Item.second.Lastseen + 15) < Currenttime; });
 
         // TODO(tcn): Poll a server for a listing.
 
@@ -50,49 +68,117 @@ namespace Matchmaking
                 { "Hostname", Localsession.Hostinfo.Username.asUTF8() },
                 { "HostID", Localsession.Hostinfo.ID.Raw },
                 { "Sessiondata", Localsession.JSONData },
-                { "Signature", Localsession.Signature }
+                { "Signature", Localsession.Signature },
+                { "Ed25519signature", Localsession.Ed25519signature }
             });
             Backend::Sendmessage(Hash::FNV1_32("Sessionupdate"), DumpJSON(Object), Backend::Matchmakeport);
         }
     }
+    static void Publishsession(Session_t &&Session)
+    {
+        std::erase_if(LANSessions, [&](const auto &Item)
+        {
+            return Item.Hostinfo.ID.Raw == Session.Hostinfo.ID.Raw;
+        });
+        LANSessions.push_back(std::move(Session));
+    }
     void __cdecl LANUpdatehandler(uint32_t NodeID, const char *JSONString)
     {
         const auto Client = Clientinfo::getNetworkclient(NodeID);
         if (!Client || Client->AccountID.Raw == 0) [[unlikely]]
             return; // WTF?
 
-        const auto Publickey = Clientinfo::getPublickey(Client->AccountID.AccountID);
-        if (Publickey.empty()) return;
+        const auto Publickey = Clientinfo::getParsedkey(Client->AccountID.AccountID);
+        if (!Publickey) return;
 
         Session_t Session{ true, uint32_t(time(NULL)) };
 
         const auto Request = ParseJSON(JSONString);
         Session.Signature = Request.value("Signature", std::string());
+        Session.Ed25519signature = Request.value("Ed25519signature", std::string());
         Session.Hostinfo.ID.Raw = Request.value("HostID", uint64_t());
         Session.JSONData = Request.value("Sessiondata", std::string());
         Session.Hostinfo.Locale = Request.value("Locale", std::u8string());
         Session.Hostinfo.Username = Request.value("Hostname", std::u8string());
 
         // Basic validation.
+        const auto &Signature = Signedwith(Session, Publickey.get());
         if (Session.Hostinfo.ID.Raw == 0) return;
-        if (Session.Signature.empty()) return;
         if (Session.JSONData.empty()) return;
+        if (Signature.empty()) return;
 
-        // Session-data has been modified or damaged.
-        if (!PK_RSA::Verifysignature(Session.JSONData, Session.Signature, Base64::Decode(Publickey)))
-            return;
+        // FNV is cheap but not collision-resistant, so hits are compared in full.
+        auto Payloadhash = Hash::FNV1a_64(std::string_view(Session.JSONData)) ^ Hash::FNV1a_64(std::string_view(Signature));
+        Payloadhash ^= Hash::FNV1a_64(&Session.Hostinfo.ID.Raw, sizeof(uint64_t)) + Client->AccountID.AccountID;
 
-        std::erase_if(LANSessions, [&](const auto &Item)
+        if (const auto Result = Verifiedpayloads.find(Payloadhash); Result != Verifiedpayloads.end())
         {
-            return Item.Hostinfo.ID.Raw == Session.Hostinfo.ID.Raw;
+            auto &Entry = Result->second;
+            if (Entry.SenderID == Client->AccountID.AccountID && Entry.HostID == Session.Hostinfo.ID.Raw &&
+                Entry.Signature == Signature && Entry.JSONData == Session.JSONData) [[likely]]
+            {
+                Entry.Lastseen = Session.Lastmessage;
+                Publishsession(std::move(Session));
+                return;
+            }
+        }
+
+        // Already being verified.
+        if (!Pendingpayloads.insert(Payloadhash).second) return;
+
+        // Verified in batches on the worker pool, so the network thread never waits on signatures.
+        Unverified.push_back({ Payloadhash, false, Client->AccountID.AccountID, std::move(Session), Publickey });
+    }
+    void __cdecl Collectverified()
+    {
+        std::vector<Verification_t> Results;
+        {
+            std::scoped_lock Lock(Resultlock);
+            if (Verificationresults.empty()) [[likely]] return;
+            Results.swap(Verificationresults);
+        }
+
+        for (auto &Result : Results)
+        {
+            Pendingpayloads.erase(Result.Payloadhash);
+
+            // Session-data has been modified or damaged.
+            if (!Result.isValid) continue;
+
+            Verifiedpayloads[Result.Payloadhash] = { Result.Session.Lastmessage, Result.SenderID, Result.Session.Hostinfo.ID.Raw,
+                                                     Result.Session.JSONData, Signedwith(Result.Session, Result.Publickey.get()) };
+            Publishsession(std::move(Result.Session));
+        }
+    }
+    void __cdecl Verifysessions()
+    {
+        if (Unverified.empty()) [[likely]] return;
+
+        // One job per tick rather than per session.
+        Backend::Enqueuejob([Batch = std::exchange(Unverified, {})]() mutable
+        {
+            std::vector<PK_Signature::Batchitem_t> Items;
+            Items.reserve(Batch.size());
+
+            for (const auto &Item : Batch)
+                Items.push_back({ Item.Session.JSONData, Signedwith(Item.Session, Item.Publickey.get()), Item.Publickey.get() });
+            PK_Signature::Verifybatch(Items);
+
+            std::scoped_lock Lock(Resultlock);
+            for (size_t i = 0; i < Batch.size(); ++i)
+            {
+                Batch[i].isValid = Items[i].isValid;
+                Verificationresults.push_back(std::move(Batch[i]));
+            }
         });
-        LANSessions.push_back(std::move(Session));
     }
 
     // Register handlers and set up session.
     void Initialize()
     {
         Backend::Enqueuetask(5000, Sessionupdate);
+        Backend::Enqueuetask(0, Collectverified);
+        Backend::Enqueuetask(0, Verifysessions);
         Backend::Registermessagehandler(Hash::FNV1_32("Sessionupdate"), LANUpdatehandler);
     }
 }
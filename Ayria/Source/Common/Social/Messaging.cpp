@@ -70,14 +70,39 @@ namespace Social
             }
             bool toClientencrypted(uint32_t ClientID, std::u8string_view Message)
             {
-                // Key-request is automatically issued if missing, try again later.
-                const auto Publickey = Clientinfo::getPublickey(ClientID);
-                if (Publickey.empty()) return false;
+                // Key-exchange is automatically issued if missing, try again later.
+                const auto Channel = Clientinfo::getChannel(ClientID);
+                if (!Channel)
+                {
+                    // Older clients only share RSA keys, so they get the previous scheme.
+                    const auto Publickey = Clientinfo::getEncryptionkey(ClientID);
+                    if (!Publickey) return false;
+
+                    auto Object = nlohmann::json::object();
+                    Object["Target"] = ClientID;
+                    Object["Message"] = PK_RSA::Encrypt(Message, Publickey.get());
+
+                    Backend::Sendmessage(Hash::FNV1_32("MSG_toClient_enc"), DumpJSON(Object));
+                    return true;
+                }
+
+                // Nonce + ciphertext + tag, the target is authenticated so the message can't be redirected.
+                constexpr auto IVsize = AES::GCM::IVsize, Tagsize = AES::GCM::Tagsize;
+                std::string Packet(IVsize + Message.size() + Tagsize, '\0');
+                const auto Buffer = (uint8_t *)Packet.data();
+                if (1 != RAND_bytes(Buffer, IVsize)) return false;
+                {
+                    std::scoped_lock Lock(Channel->Lock);
+                    if (!Channel->Cipher.Encrypt({ (const uint8_t *)Message.data(), Message.size() }, { Buffer + IVsize, Message.size() },
+                        std::span<const uint8_t, IVsize>(Buffer, IVsize), std::span<uint8_t, Tagsize>(Buffer + IVsize + Message.size(), Tagsize),
+                        { (const uint8_t *)&ClientID, sizeof(ClientID) })) return false;
+                }
 
                 // Simple identifier, more options can be added to message.
                 auto Object = nlohmann::json::object();
                 Object["Target"] = ClientID;
-                Object["Message"] = PK_RSA::Encrypt(Message, Base64::Decode(Publickey));
+                Object["Scheme"] = "AES-GCM";
+                Object["Message"] = Base64::Encode(Packet);
 
                 Backend::Sendmessage(Hash::FNV1_32("MSG_toClient_enc"), DumpJSON(Object));
                 return true;
@@ -130,16 +155,42 @@ namespace Social
 
             const auto Request = ParseJSON(JSONString);
             const auto Target = Request.value("Target", uint32_t());
-            const auto Message = Request.value("Message", std::u8string());
+            const auto Scheme = Request.value("Scheme", std::string());
 
             const auto Self = Clientinfo::getLocalclient();
-            if (Target == Self->ID.AccountID)
+            if (Target != Self->ID.AccountID) return;
+
+            // Older clients, and peers that have no channel to us yet, encrypt with our RSA key.
+            if (Scheme.empty())
             {
-                const auto Key = Clientinfo::getSessionkey();
-                const auto Decrypted = PK_RSA::Decrypt(Message, Key);
+                const auto Message = Request.value("Message", std::u8string());
+                const auto Decrypted = PK_RSA::Decrypt(Message, Clientinfo::getSessionkey());
                 if (!Decrypted.empty())
                     Messages.push_back({ (uint32_t)time(NULL), Client->AccountID,
-                        std::u8string((char8_t*)Decrypted.data(), Decrypted.size()) });
+                        std::u8string((char8_t *)Decrypted.data(), Decrypted.size()) });
+            }
+            else if (Scheme == "AES-GCM")
+            {
+                const auto Message = Request.value("Message", std::string());
+                const auto Channel = Clientinfo::getChannel(Client->AccountID.AccountID);
+                if (!Channel) return;
+
+                constexpr auto IVsize = AES::GCM::IVsize, Tagsize = AES::GCM::Tagsize;
+                const auto Packet = Base64::Decode(Message);
+                if (Packet.size() < IVsize + Tagsize) [[unlikely]] return;
+
+                const auto Buffer = (const uint8_t *)Packet.data();
+                const auto Payloadsize = Packet.size() - IVsize - Tagsize;
+                std::u8string Decrypted(Payloadsize, u8'\0');
+                {
+                    std::scoped_lock Lock(Channel->Lock);
+                    if (!Channel->Cipher.Decrypt({ Buffer + IVsize, Payloadsize }, { (uint8_t *)Decrypted.data(), Payloadsize },
+                        std::span<const uint8_t, IVsize>(Buffer, IVsize), std::span<const uint8_t, Tagsize>(Buffer + IVsize + Payloadsize, Tagsize),
+                        { (const uint8_t *)&Target, sizeof(Target) })) return;
+                }
+
+                if (!Decrypted.empty())
+                    Messages.push_back({ (uint32_t)time(NULL), Client->AccountID, std::move(Decrypted) });
             }
         }
 
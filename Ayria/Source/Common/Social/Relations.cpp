@@ -13,32 +13,61 @@ namespace Social
     {
         std::vector<Relation_t> Relations;
 
+        // Modifications vs the serializer on the IO thread.
+        std::mutex Relationslock;
+
+        // Stored as "Relations/<UserID>" = { uint32_t Flags, char8_t Username[] }.
+        static std::string toKey(uint32_t UserID)
+        {
+            return "Relations/"s + std::to_string(UserID);
+        }
+        static void Store(const Relation_t &Relation)
+        {
+            Blob Value(sizeof(Relation.Flags), 0);
+            std::memcpy(Value.data(), &Relation.Flags, sizeof(Relation.Flags));
+            Value.append((const uint8_t *)Relation.Username.data(), Relation.Username.size());
+
+            getStorage()->Put(toKey(Relation.AccountID), Value);
+        }
+
         void Add(uint32_t UserID, std::u8string_view Username, uint32_t Relationflags)
         {
-            // Update existing.
-            for (auto &Item : Relations)
             {
-                if (Item.AccountID == UserID)
+                std::scoped_lock Guard(Relationslock);
+                const auto Existing = std::find_if(Relations.begin(), Relations.end(), [&](const auto &Item) { return Item.AccountID == UserID; });
+
+                // Update existing.
+                if (Existing != Relations.end())
                 {
-                    Item.Flags |= Relationflags;
+                    Existing->Flags |= Relationflags;
 
                     if (!Username.empty())
-                        Item.Username = Username;
+                        Existing->Username = Username;
 
-                    Save();
-                    return;
+                    Store(*Existing);
+                }
+                else
+                {
+                    Relations.push_back({ UserID, std::u8string(Username), Relationflags });
+                    Store(Relations.back());
                 }
             }
 
-            Relations.push_back({ UserID, std::u8string(Username), Relationflags });
             Save();
         }
         void Remove(uint32_t UserID, std::u8string_view Username)
         {
-            std::erase_if(Relations, [&](const auto &Item)
             {
-                return (UserID == Item.AccountID) || (Username == Item.Username);
-            });
+                std::scoped_lock Guard(Relationslock);
+                std::erase_if(Relations, [&](const auto &Item)
+                {
+                    if ((UserID != Item.AccountID) && (Username != Item.Username)) return false;
+
+                    getStorage()->Erase(toKey(Item.AccountID));
+                    return true;
+                });
+            }
+
             Save();
         }
         const std::vector<Relation_t> *Get()
@@ -46,9 +75,23 @@ namespace Social
             return &Relations;
         }
 
-        // Disk management.
+        // Disk management, the storage is authoritative and the JSON export is merged on top of it.
         void Load(std::wstring_view Path)
         {
+            {
+                std::scoped_lock Guard(Relationslock);
+                getStorage()->Scan("Relations/", [](std::string_view Key, Blob_view Value)
+                {
+                    if (Value.size() < sizeof(uint32_t)) return;
+
+                    Relation_t Relation;
+                    std::memcpy(&Relation.Flags, Value.data(), sizeof(uint32_t));
+                    std::from_chars(Key.data() + Key.find('/') + 1, Key.data() + Key.size(), Relation.AccountID);
+                    Relation.Username.assign((const char8_t *)Value.data() + sizeof(uint32_t), Value.size() - sizeof(uint32_t));
+                    Relations.push_back(std::move(Relation));
+                });
+            }
+
             const auto Filebuffer = FS::Readfile(Path);
             if (Filebuffer.empty()) return;
 
@@ -59,31 +102,51 @@ namespace Social
                 return;
             }
 
+            // The user may have edited the file, so its entries win; removals need to go through Remove().
+            std::scoped_lock Guard(Relationslock);
             for (const auto &Object : Array)
             {
                 Relation_t Relation;
                 Relation.Flags = Object.value("Flags", uint32_t());
                 Relation.AccountID = Object.value("UserID", uint32_t());
                 Relation.Username = Object.value("Username", std::u8string());
-                if (Relation.AccountID != 0) Relations.push_back(std::move(Relation));
+                if (Relation.AccountID == 0) continue;
+
+                const auto Existing = std::find_if(Relations.begin(), Relations.end(), [&](const auto &Item) { return Item.AccountID == Relation.AccountID; });
+                if (Existing == Relations.end())
+                {
+                    Relations.push_back(std::move(Relation));
+                    Store(Relations.back());
+                }
+                else if (Existing->Flags != Relation.Flags || Existing->Username != Relation.Username)
+                {
+                    *Existing = std::move(Relation);
+                    Store(*Existing);
+                }
             }
         }
         void Save(std::wstring_view Path)
         {
-            auto Array = nlohmann::json::array();
-            for (const auto &[ID, Username, Flags] : *Relations::Get())
+            // Export for the user, serialized and written from the IO thread.
+            FS::Async::Writebehind(Path, []()
             {
-                const Relationflags_t Internal{ Flags };
-                if (Internal.isFriend)
+                auto Array = nlohmann::json::array();
                 {
-                    Array += { { "Username", Username }, { "UserID", ID }, { "Flags", Flags }};
+                    std::scoped_lock Guard(Relationslock);
+                    for (const auto &[ID, Username, Flags] : Relations)
+                    {
+                        const Relationflags_t Internal{ Flags };
+                        if (Internal.isFriend)
+                        {
+                            Array += { { "Username", Username }, { "UserID", ID }, { "Flags", Flags }};
+                        }
+                    }
                 }
-            }
 
-            FS::Writefile(Path,
-                "// Auto-generated by Ayria, remember to escape UTF8 chars..\n"s +
-                "Format: [ { Username, UserID, Flags }, ...] \n"s +
-                Array.dump(4, ' ', true));
+                return S2B("// Auto-generated by Ayria, remember to escape UTF8 chars..\n"s +
+                           "// Format: [ { Username, UserID, Flags }, ...] \n"s +
+                           Array.dump(4, ' ', true));
+            }, std::chrono::seconds(2));
         }
     }
 }
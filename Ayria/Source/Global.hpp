@@ -360,6 +360,19 @@ struct Ayriamodule_t
     }
 };
 
+// Persistent state shared by the modules, keys are "Category/ID".
+inline Kvstore_t *getStorage()
+{
+    static const auto Storage = []()
+    {
+        const auto Temp = new Kvstore_t("./Ayria/Storage.kv");
+        if (!Temp->Valid()) Errorprint("./Ayria/Storage.kv could not be opened, nothing will be saved.");
+        else if (Temp->isPrivate()) Warningprint("./Ayria/Storage.kv is used by another instance, changes in this one will not be saved.");
+        return Temp;
+    }();
+    return Storage;
+}
+
 // Core systems.
 #include <Backend/Backend.hpp>
 
@@ -0,0 +1,34 @@
+/*
+    Initial author: Convery (tcn@ayria.se)
+    Started: 2020-11-20
+    License: MIT
+*/
+
+#include "Benchmark.hpp"
+
+int main(int Argc, char **Argv)
+{
+    for (int i = Argc > 1 ? 1 : 0; i < Argc; ++i)
+        Benchmark::Binaries.emplace_back(Argv[i]);
+
+    const std::pair<const char *, bool (*)()> Suites[] =
+    {
+        { "Hashing", Benchmark::Hashing },
+        { "Scanning", Benchmark::Scanning },
+        { "Bitpacking", Benchmark::Bitpacking },
+        { "Bytepacking", Benchmark::Bytepacking }
+    };
+
+    int Failures{};
+    for (const auto &[Name, Suite] : Suites)
+    {
+        std::printf("%s:\n", Name);
+        if (!Suite())
+        {
+            std::printf("    %s failed its cross-check.\n", Name);
+            Failures++;
+        }
+    }
+
+    return Failures;
+}
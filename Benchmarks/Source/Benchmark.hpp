@@ -0,0 +1,53 @@
+/*
+    Initial author: Convery (tcn@ayria.se)
+    Started: 2020-11-20
+    License: MIT
+
+    Cross-checks and throughput of the accelerated utilities, kept out of the modules.
+    Every suite compares its paths against a simple reference before timing them.
+*/
+
+#pragma once
+#include <Stdinclude.hpp>
+
+namespace Benchmark
+{
+    // Best of Rounds in MB/s.
+    template <typename Function> double Throughput(size_t Bytes, Function &&Callback, size_t Rounds = 5)
+    {
+        double Best{};
+        for (size_t i = 0; i < Rounds; ++i)
+        {
+            const auto Start = std::chrono::steady_clock::now();
+            Callback();
+            const std::chrono::duration<double> Elapsed = std::chrono::steady_clock::now() - Start;
+            Best = std::max(Best, double(Bytes) / 1e6 / std::max(Elapsed.count(), 1e-9));
+        }
+
+        return Best;
+    }
+
+    // Results are stored here so the optimizer can not drop the work.
+    inline volatile uint64_t Sink{};
+
+    // xorshift64, reproducible between runs.
+    inline uint64_t Random(uint64_t &Seed)
+    {
+        Seed ^= Seed << 13; Seed ^= Seed >> 7; Seed ^= Seed << 17;
+        return Seed;
+    }
+
+    inline void Print(std::string_view Name, double Speed)
+    {
+        std::printf("    %-28.*s %8.0f MB/s\n", int(Name.size()), Name.data(), Speed);
+    }
+
+    // Real modules to scan, from the commandline or our own executable.
+    inline std::vector<std::string> Binaries;
+
+    // The suites return false on a mismatch.
+    bool Hashing();
+    bool Scanning();
+    bool Bitpacking();
+    bool Bytepacking();
+}
@@ -0,0 +1,152 @@
+/*
+    Initial author: Convery (tcn@ayria.se)
+    Started: 2020-11-20
+    License: MIT
+*/
+
+#include "Benchmark.hpp"
+
+namespace Benchmark
+{
+    // One bit per step, LSB first, the reference layout for the word-sized paths.
+    static void Writebits(std::vector<uint8_t> &Output, size_t &Position, size_t Count, const uint8_t *Input)
+    {
+        Output.resize(std::max(Output.size(), (Position + Count + 7) / 8));
+        for (size_t i = 0; i < Count; ++i, ++Position)
+        {
+            const auto Bit = (Input[i / 8] >> (i & 7)) & 1;
+            Output[Position / 8] = uint8_t((Output[Position / 8] & ~(1 << (Position & 7))) | (Bit << (Position & 7)));
+        }
+    }
+    static void Readbits(const std::vector<uint8_t> &Input, size_t &Position, size_t Count, uint8_t *Output)
+    {
+        std::memset(Output, 0, (Count + 7) / 8);
+        for (size_t i = 0; i < Count; ++i, ++Position)
+            Output[i / 8] |= uint8_t(((Input[Position / 8] >> (Position & 7)) & 1) << (i & 7));
+    }
+
+    // Random widths up to 256 bits with the occasional string, written and read back in different chunks.
+    static bool Crosscheck(size_t Rounds)
+    {
+        constexpr uint8_t Zero[8]{};
+        constexpr std::string_view Text{ "snapshot" };
+        uint8_t Input[32], Output[32], Expected[32];
+        uint64_t Seed{ 0x9E3779B97F4A7C15 };
+
+        for (size_t i = 0; i < Rounds; ++i)
+        {
+            Bitbuffer Buffer;
+            Buffer.Quakecompatibible = Random(Seed) & 1;
+            std::vector<uint8_t> Reference;
+            size_t Position{};
+
+            const auto Fields = Random(Seed) % 64;
+            for (size_t n = 0; n < Fields; ++n)
+            {
+                for (auto &Item : Input) Item = uint8_t(Random(Seed));
+                const auto Width = size_t(Random(Seed) % 257);
+
+                Buffer.Rawwrite(Width, Input);
+                Writebits(Reference, Position, Width, Input);
+
+                // Quake pads strings to the next byte with zeroes.
+                if (Random(Seed) % 8 == 0)
+                {
+                    Buffer.Write(std::string(Text), false);
+                    if (Buffer.Quakecompatibible && Position % 8) Writebits(Reference, Position, 8 - Position % 8, Zero);
+                    Writebits(Reference, Position, (Text.size() + 1) * 8, (const uint8_t *)Text.data());
+                }
+            }
+
+            if (Buffer.Internalsize != Reference.size()) return false;
+            if (Buffer.Internalsize && std::memcmp(Buffer.Internalbuffer.get(), Reference.data(), Reference.size())) return false;
+
+            size_t Readposition{};
+            Buffer.Internaliterator = 0;
+            while (Readposition < Position)
+            {
+                const auto Count = std::min(size_t(Random(Seed) % 257), Position - Readposition);
+                if (!Buffer.Rawread(Count, Output)) return false;
+
+                Readbits(Reference, Readposition, Count, Expected);
+                if (std::memcmp(Output, Expected, (Count + 7) / 8)) return false;
+            }
+
+            // Only the padding of the last byte is left.
+            if (Buffer.Rawread(8 + Reference.size() * 8 - Position, Output)) return false;
+        }
+
+        return true;
+    }
+
+    bool Bitpacking()
+    {
+        if (!Crosscheck(20000)) return false;
+
+        // Snapshot-like fields, mostly flags and small counters with the occasional full word.
+        constexpr size_t Count = 1024 * 1024;
+        std::vector<std::pair<uint8_t, uint64_t>> Fields(Count);
+        uint64_t Seed{ 0x2545F4914F6CDD1D };
+        size_t Bits{};
+
+        for (auto &[Width, Value] : Fields)
+        {
+            Width = uint8_t(Random(Seed) % 8 ? 1 + Random(Seed) % 12 : 32);
+            Value = Random(Seed);
+            Bits += Width;
+        }
+
+        Print("Mixed fields, bit-at-a-time", Throughput(Bits / 8, [&]()
+        {
+            std::vector<uint8_t> Output;
+            size_t Position{};
+
+            for (const auto &[Width, Value] : Fields) Writebits(Output, Position, Width, (const uint8_t *)&Value);
+            Sink = Output.size();
+        }));
+
+        Bitbuffer Written;
+        Print("Mixed fields, written", Throughput(Bits / 8, [&]()
+        {
+            Bitbuffer Buffer;
+            for (const auto &[Width, Value] : Fields) Buffer.Rawwrite(Width, &Value);
+
+            Sink = Buffer.Internalsize;
+            Written = std::move(Buffer);
+        }));
+
+        Print("Mixed fields, read", Throughput(Bits / 8, [&]()
+        {
+            uint64_t Sum{};
+            Written.Internaliterator = 0;
+
+            for (const auto &[Width, Value] : Fields)
+            {
+                uint64_t Field{};
+                Written.Rawread(Width, &Field);
+                Sum += Field;
+            }
+
+            Sink = Sum;
+        }));
+
+        // Byte-aligned blocks take the memcpy path.
+        constexpr size_t Blocksize = 1024, Blockcount = 16 * 1024;
+        const std::vector<uint8_t> Block(Blocksize, 0xA5);
+        Print("1 KiB blocks, aligned", Throughput(Blocksize * Blockcount, [&]()
+        {
+            Bitbuffer Buffer;
+            for (size_t i = 0; i < Blockcount; ++i) Buffer.Rawwrite(Blocksize * 8, Block.data());
+            Sink = Buffer.Internalsize;
+        }));
+        Print("1 KiB blocks, unaligned", Throughput(Blocksize * Blockcount, [&]()
+        {
+            Bitbuffer Buffer;
+            Buffer.Rawwrite(3);
+            for (size_t i = 0; i < Blockcount; ++i) Buffer.Rawwrite(Blocksize * 8, Block.data());
+            Sink = Buffer.Internalsize;
+        }));
+
+        return true;
+    }
+}
@@ -0,0 +1,189 @@
+/*
+    Initial author: Convery (tcn@ayria.se)
+    Started: 2020-11-20
+    License: MIT
+*/
+
+#include "Benchmark.hpp"
+
+namespace Benchmark
+{
+    // What clients announce on the LAN.
+    struct Discovery_t
+    {
+        uint64_t AccountID;
+        std::string Locale, Username;
+
+        bool operator == (const Discovery_t &) const = default;
+        static constexpr auto Schema = bbSchema(&Discovery_t::AccountID, &Discovery_t::Locale, &Discovery_t::Username);
+    };
+
+    // A hosted session and its players.
+    struct Session_t
+    {
+        uint64_t HostID;
+        uint32_t SessionID, Hostaddress;
+        uint16_t Hostport;
+        uint8_t Playercount, Maxplayers;
+        std::string Gamemode, Mapname;
+        std::vector<uint64_t> Players;
+
+        bool operator == (const Session_t &) const = default;
+        static constexpr auto Schema = bbSchema(&Session_t::HostID, &Session_t::SessionID, &Session_t::Hostaddress, &Session_t::Hostport,
+                                                &Session_t::Playercount, &Session_t::Maxplayers, &Session_t::Gamemode, &Session_t::Mapname, &Session_t::Players);
+    };
+
+    static Discovery_t Randomdiscovery(uint64_t &Seed)
+    {
+        return { 0x0001000000000000ULL | Random(Seed) % 100000, "English", "Player" + std::to_string(Random(Seed) % 10000) };
+    }
+    static Session_t Randomsession(uint64_t &Seed)
+    {
+        Session_t Session{ Random(Seed), uint32_t(Random(Seed)), uint32_t(Random(Seed)), uint16_t(Random(Seed)), 0, 18, "Team deathmatch", "mp_crossfire", {} };
+
+        Session.Playercount = uint8_t(Random(Seed) % 19);
+        for (uint8_t i = 0; i < Session.Playercount; ++i) Session.Players.push_back(0x0001000000000000ULL | Random(Seed) % 100000);
+        return Session;
+    }
+
+    // The previous growth, an allocation of exactly the new size for every append.
+    static void Appendexact(std::unique_ptr<uint8_t[]> &Buffer, size_t &Size, const void *Data, size_t Length)
+    {
+        auto Newbuffer = std::make_unique<uint8_t[]>(Size + Length);
+        if (Size) std::memcpy(Newbuffer.get(), Buffer.get(), Size);
+        std::memcpy(Newbuffer.get() + Size, Data, Length);
+
+        Buffer.swap(Newbuffer);
+        Size += Length;
+    }
+
+    // Payloads through both modes and both readers, then enough fields to move from the inline storage to the heap.
+    static bool Crosscheck(size_t Rounds)
+    {
+        uint64_t Seed{ 0x9E3779B97F4A7C15 };
+
+        for (size_t i = 0; i < Rounds; ++i)
+        {
+            const bool Trusted = i & 1;
+            const auto Discovery = Randomdiscovery(Seed);
+            const auto Session = Randomsession(Seed);
+
+            Bytebuffer Buffer;
+            bbPack(Buffer, Discovery, Trusted);
+            bbPack(Buffer, Session, Trusted);
+
+            Discovery_t Discoverycopy{};
+            Session_t Sessioncopy{};
+            Bytebufferview View(Buffer.asView());
+            if (!bbUnpack(View, Discoverycopy, Trusted) || !bbUnpack(View, Sessioncopy, Trusted)) return false;
+            if (Discoverycopy != Discovery || Sessioncopy != Session) return false;
+
+            Buffer.Rewind();
+            Bytebuffer Moved(std::move(Buffer));
+            if (!bbUnpack(Moved, Discoverycopy, Trusted) || !bbUnpack(Moved, Sessioncopy, Trusted)) return false;
+            if (Discoverycopy != Discovery || Sessioncopy != Session) return false;
+
+            const auto Count = size_t(Random(Seed) % 1024);
+            std::unique_ptr<uint8_t[]> Reference;
+            size_t Referencesize{};
+            Bytebuffer Fields;
+
+            for (uint32_t n = 0; n < Count; ++n)
+            {
+                Fields.Write(n, false);
+                Appendexact(Reference, Referencesize, &n, sizeof(n));
+            }
+
+            const Bytebuffer Copy(Fields);
+            if (Copy.Internalsize != Referencesize || Copy.Internalbuffer[Copy.Internalsize] != 0) return false;
+            if (Referencesize && std::memcmp(Copy.Internalbuffer, Reference.get(), Referencesize)) return false;
+        }
+
+        return true;
+    }
+
+    bool Bytepacking()
+    {
+        if (!Crosscheck(20000)) return false;
+
+        // Pre-generated so that only the serialization is timed.
+        constexpr size_t Count = 256 * 1024;
+        std::vector<Discovery_t> Discoveries;
+        std::vector<Session_t> Sessions;
+        std::vector<Blob> Packeddiscoveries, Packedsessions;
+        size_t Discoverysize{}, Sessionsize{};
+        uint64_t Seed{ 0x2545F4914F6CDD1D };
+
+        for (size_t i = 0; i < Count; ++i)
+        {
+            Discoveries.push_back(Randomdiscovery(Seed));
+            Sessions.push_back(Randomsession(Seed));
+
+            Packeddiscoveries.push_back(bbPack(Discoveries.back()));
+            Packedsessions.push_back(bbPack(Sessions.back()));
+            Discoverysize += Packeddiscoveries.back().size();
+            Sessionsize += Packedsessions.back().size();
+        }
+
+        // A fresh buffer per packet, as the networking does.
+        const auto Pack = [](const auto &Payloads, size_t Size)
+        {
+            return Throughput(Size, [&]()
+            {
+                for (const auto &Payload : Payloads)
+                {
+                    Bytebuffer Buffer;
+                    bbPack(Buffer, Payload);
+                    Sink = Buffer.Internalsize;
+                }
+            });
+        };
+        const auto Unpack = [](const std::vector<Blob> &Packets, auto Payload, size_t Size)
+        {
+            return Throughput(Size, [&]()
+            {
+                for (const auto &Packet : Packets)
+                {
+                    Bytebufferview Buffer(Packet);
+                    Sink = bbUnpack(Buffer, Payload);
+                }
+            });
+        };
+
+        std::printf("  Discovery (%zu B average)\n", Discoverysize / Count);
+        Print("Packed", Pack(Discoveries, Discoverysize));
+        Print("Unpacked", Unpack(Packeddiscoveries, Discovery_t{}, Discoverysize));
+
+        std::printf("  Session (%zu B average)\n", Sessionsize / Count);
+        Print("Packed", Pack(Sessions, Sessionsize));
+        Print("Unpacked", Unpack(Packedsessions, Session_t{}, Sessionsize));
+
+        // Appending fields to a single buffer, the exact-size growth is quadratic so this is kept small.
+        constexpr uint32_t Fieldcount = 16 * 1024;
+        std::printf("  Appending (%u KiB)\n", unsigned(Fieldcount * sizeof(uint32_t) / 1024));
+
+        Print("Exact-size growth", Throughput(Fieldcount * sizeof(uint32_t), [&]()
+        {
+            std::unique_ptr<uint8_t[]> Buffer;
+            size_t Size{};
+
+            for (uint32_t i = 0; i < Fieldcount; ++i) Appendexact(Buffer, Size, &i, sizeof(i));
+            Sink = Size;
+        }));
+        Print("Doubling", Throughput(Fieldcount * sizeof(uint32_t), [&]()
+        {
+            Bytebuffer Buffer;
+            for (uint32_t i = 0; i < Fieldcount; ++i) Buffer.Write(i, false);
+            Sink = Buffer.Internalsize;
+        }));
+        Print("Reserved", Throughput(Fieldcount * sizeof(uint32_t), [&]()
+        {
+            Bytebuffer Buffer;
+            Buffer.Reserve(Fieldcount * sizeof(uint32_t) + 1);
+            for (uint32_t i = 0; i < Fieldcount; ++i) Buffer.Write(i, false);
+            Sink = Buffer.Internalsize;
+        }));
+
+        return true;
+    }
+}
@@ -0,0 +1,83 @@
+/*
+    Initial author: Convery (tcn@ayria.se)
+    Started: 2020-11-20
+    License: MIT
+*/
+
+#include "Benchmark.hpp"
+
+namespace Benchmark
+{
+    using namespace Hash::Internal;
+
+    // One table-lookup per byte, the reference for the accelerated paths.
+    static uint32_t CRC32A_Bytewise(uint32_t Block, const uint8_t *Input, size_t Length)
+    {
+        static constexpr auto Table = CRC32A_Table();
+        while (Length--) Block = (Block << 8) ^ Table[(Block >> 24) ^ *Input++];
+        return Block;
+    }
+    static uint32_t CRC32B_Bytewise(uint32_t Block, const uint8_t *Input, size_t Length)
+    {
+        static constexpr auto Table = CRC32B_Table();
+        while (Length--) Block = (Block >> 8) ^ Table[(Block ^ *Input++) & 0xFF];
+        return Block;
+    }
+
+    // Random lengths, alignments and registers through every path this CPU supports.
+    static bool Crosscheck(size_t Rounds)
+    {
+        const bool hasPCLMUL = Cpufeatures::hasPCLMUL(), hasSSSE3 = Cpufeatures::hasSSSE3();
+        uint64_t Seed{ 0x9E3779B97F4A7C15 };
+
+        std::vector<uint8_t> Buffer(4096 + 64);
+        for (auto &Item : Buffer) Item = uint8_t(Random(Seed));
+
+        for (size_t i = 0; i < Rounds; ++i)
+        {
+            const auto Input = Buffer.data() + Random(Seed) % 64;
+            const auto Length = size_t(Random(Seed) % 4097);
+            const auto Block = uint32_t(Random(Seed));
+
+            const auto A = CRC32A_Bytewise(Block, Input, Length);
+            const auto B = CRC32B_Bytewise(Block, Input, Length);
+            if (A != CRC32A_Slicing(Block, Input, Length) || A != CRC32A_Update(Block, Input, Length)) return false;
+            if (B != CRC32B_Slicing(Block, Input, Length) || B != CRC32B_Update(Block, Input, Length)) return false;
+
+            // The folding itself, without the slicing tail.
+            const auto Folded = Length & ~size_t(15);
+            if (Folded < 64 || !hasPCLMUL) continue;
+
+            if (hasSSSE3 && CRC32A_PCLMUL(Block, Input, Folded) != CRC32A_Bytewise(Block, Input, Folded)) return false;
+            if (CRC32B_PCLMUL(Block, Input, Folded) != CRC32B_Bytewise(Block, Input, Folded)) return false;
+        }
+
+        return true;
+    }
+
+    bool Hashing()
+    {
+        if (!Crosscheck(20000)) return false;
+
+        // A multiple of 16, so PCLMUL folds all of it.
+        constexpr size_t Size = 16 * 1024 * 1024;
+        std::vector<uint8_t> Buffer(Size);
+        uint64_t Seed{ 0x2545F4914F6CDD1D };
+        for (auto &Item : Buffer) Item = uint8_t(Random(Seed));
+
+        const auto Measure = [&](std::string_view Name, uint32_t (*Function)(uint32_t, const uint8_t *, size_t))
+        {
+            Print(Name, Throughput(Size, [&]() { Sink = Function(0xFFFFFFFF, Buffer.data(), Size); }));
+        };
+
+        Measure("CRC32A bytewise", CRC32A_Bytewise);
+        Measure("CRC32A slice-by-16", CRC32A_Slicing);
+        if (Cpufeatures::hasPCLMUL() && Cpufeatures::hasSSSE3()) Measure("CRC32A PCLMUL", CRC32A_PCLMUL);
+        Measure("CRC32B bytewise", CRC32B_Bytewise);
+        Measure("CRC32B slice-by-16", CRC32B_Slicing);
+        if (Cpufeatures::hasPCLMUL()) Measure("CRC32B PCLMUL", CRC32B_PCLMUL);
+        Measure("CRC32B dispatched", CRC32B_Update);
+
+        return true;
+    }
+}
@@ -0,0 +1,103 @@
+/*
+    Initial author: Convery (tcn@ayria.se)
+    Started: 2020-11-20
+    License: MIT
+*/
+
+#include "Benchmark.hpp"
+
+namespace Benchmark
+{
+    using namespace Patternscan::Internal;
+    using Finder_t = const uint8_t *(*)(const Matcher_t &, const uint8_t *, const uint8_t *);
+
+    // Every position compared in full, the reference for the anchored scanners.
+    static const uint8_t *Find_reference(const Matcher_t &Matcher, const uint8_t *Begin, const uint8_t *End)
+    {
+        for (auto Address = Begin; size_t(End - Address) >= Matcher.Pattern.size(); ++Address)
+            if (Matcher.Compare(Address)) return Address;
+        return nullptr;
+    }
+    static size_t Countmatches(const Matcher_t &Matcher, Finder_t Finder, const uint8_t *Begin, const uint8_t *End)
+    {
+        size_t Count{};
+        for (auto Address = Finder(Matcher, Begin, End); Address; Address = Finder(Matcher, Address + 1, End)) ++Count;
+        return Count;
+    }
+
+    // Random draws from the 64 most common code-bytes, a worst case for anchoring on a single byte.
+    static std::vector<uint8_t> Syntheticcode(size_t Size)
+    {
+        std::vector<uint8_t> Common, Buffer(Size);
+        for (size_t i = 0; i < 256; ++i) if (Byterank[i] >= 192) Common.push_back(uint8_t(i));
+
+        uint64_t Seed{ 0x9E3779B97F4A7C15 };
+        for (auto &Item : Buffer) Item = Common[Random(Seed) % Common.size()];
+        return Buffer;
+    }
+
+    // Patterns cut from a four-letter buffer with random wildcards, so most rounds have several matches.
+    static bool Crosscheck(size_t Rounds)
+    {
+        uint64_t Seed{ 0x2545F4914F6CDD1D };
+        std::vector<uint8_t> Buffer(4096);
+        for (auto &Item : Buffer) Item = uint8_t(0x48 + Random(Seed) % 4);
+
+        for (size_t i = 0; i < Rounds; ++i)
+        {
+            // Up to 300 bytes, so the scalar compare past the vector limit is covered too.
+            const auto Length = size_t(1 + Random(Seed) % (i & 1 ? 12 : 300));
+            const auto Source = Buffer.data() + Random(Seed) % (Buffer.size() - Length);
+
+            Patternscan::Patternmask_t Pattern(Source, Length), Mask(Length, 1);
+            for (auto &Item : Mask) if (Random(Seed) % 4 == 0) Item = 0;
+            for (size_t n = 0; n < Length; ++n) if (!Mask[n]) Pattern[n] = uint8_t(Random(Seed));
+
+            // Unaligned ranges that may cut the source short.
+            const auto Begin = Buffer.data() + Random(Seed) % 64;
+            const auto End = Buffer.data() + Buffer.size() - Random(Seed) % 64;
+
+            const Matcher_t Matcher(Pattern, Mask);
+            const auto Expected = Countmatches(Matcher, Find_reference, Begin, End);
+            if (Expected != Countmatches(Matcher, Find_scalar, Begin, End)) return false;
+            if (Cpufeatures::hasAVX2() && Expected != Countmatches(Matcher, Find_AVX2, Begin, End)) return false;
+        }
+
+        return true;
+    }
+
+    // Collects every match, the first-byte scan is the behaviour before the anchors.
+    static void Measure(std::string_view Title, const std::vector<uint8_t> &Buffer, Patternscan::Patternmask_view Pattern, Patternscan::Patternmask_view Mask)
+    {
+        const auto Begin = Buffer.data(), End = Buffer.data() + Buffer.size();
+        std::printf("  %.*s (%zu KiB)\n", int(Title.size()), Title.data(), Buffer.size() / 1024);
+
+        const auto Run = [&](std::string_view Name, const Matcher_t &Matcher, Finder_t Finder)
+        {
+            Print(Name, Throughput(Buffer.size(), [&]() { Sink = Countmatches(Matcher, Finder, Begin, End); }));
+        };
+
+        const Matcher_t Matcher(Pattern, Mask);
+        if (Mask[0]) Run("First byte, scalar", Matcher_t(Pattern, Mask, { 0, 0 }), Find_scalar);
+        Run("Rarest byte, scalar", Matcher, Find_scalar);
+        if (Cpufeatures::hasAVX2()) Run("Two anchors, AVX2", Matcher, Find_AVX2);
+    }
+
+    bool Scanning()
+    {
+        if (!Crosscheck(20000)) return false;
+
+        const auto [Pattern, Mask] = Patternscan::from_IDA("48 8B 05 ? ? ? ? 48 85 C0");
+        Measure("Synthetic code", Syntheticcode(64 * 1024 * 1024), Pattern, Mask);
+
+        for (const auto &Path : Binaries)
+        {
+            const auto Filebuffer = FS::Readfile(Path);
+            if (Filebuffer.size() < Pattern.size()) continue;
+
+            Measure(Path, { Filebuffer.begin(), Filebuffer.end() }, Pattern, Mask);
+        }
+
+        return true;
+    }
+}
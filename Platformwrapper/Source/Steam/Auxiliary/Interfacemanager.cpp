@@ -125,18 +125,21 @@ namespace Steam
     extern const std::vector<std::pair<std::string, std::string>> Scanstrings;
     bool Scanforinterfaces(std::string_view Filename)
     {
-        const auto Filebuffer = FS::Readfile(Filename);
+        const FS::Mappedfile Filebuffer(Filename);
         if(Filebuffer.empty()) return false;
         size_t Foundnames{};
 
         // Scan through the binary for interface-names.
         const Patternscan::Range_t Range = { size_t(Filebuffer.data()), size_t(Filebuffer.data()) + Filebuffer.size() };
-        for(const auto Address : Patternscan::Findpatterns(Range, "53")) // 'S' in hexadecimal.
+        for(const auto Address : Patternscan::Findpatterns(Range, Patternscan::Patternliteral_t("53"))) // 'S' in hexadecimal.
         {
+            // The mapping is not null-terminated, so compare in-bounds.
+            const std::string_view Remaining((const char *)Address, Range.second - Address);
+
             // Match against the scan-strings.
             for(const auto &[Scanstring, Name] : Scanstrings)
             {
-                if(std::strstr((char *)Address, Scanstring.c_str()))
+                if(Remaining.starts_with(Scanstring))
                 {
                     // Load the interface to mark it as active.
                     Fetchinterface(Name);
@@ -17,14 +17,72 @@ namespace Steam
 
         }
     */
-    static nlohmann::json getAppdata()
+
+    // The JSON is imported into the store when it changes, lookups then skip the parsing.
+    // Keys are "<AppID>/Appdata/<Key>", "<AppID>/Languages", "<AppID>/DLC/<Index>/{ID, Name}" and "<AppID>/DLCfile/<ID>".
+    static void Importappdata(Kvstore_t *Store)
     {
         const auto Filename = va("./Ayria/Assets/Steam/Appdata_%u.json", Steam.ApplicationID);
-        if (const auto Filebuffer = FS::Readfile(Filename); !Filebuffer.empty())
+        const auto Prefix = va("%u/", Steam.ApplicationID);
+
+        // Size and modification time of the JSON, zero if it has been removed.
+        std::error_code Error;
+        const auto Modified = std::filesystem::last_write_time(Filename, Error).time_since_epoch().count();
+        const auto Size = std::filesystem::file_size(Filename, Error);
+        const auto Source = Error ? 0 : (uint64_t(Size) << 32) ^ uint64_t(Modified);
+
+        if (Store->Get<uint64_t>(Prefix + "Source") == Source) return;
+
+        std::vector<std::string> Stale;
+        Store->Scan(Prefix, [&](std::string_view Key, Blob_view) { Stale.emplace_back(Key); });
+        for (const auto &Key : Stale) Store->Erase(Key);
+
+        const FS::Mappedfile Filebuffer(Filename);
+        const auto Object = Filebuffer.empty() ? nlohmann::json::object() : ParseJSON(Filebuffer.asString());
+
+        if (Object.contains("Appdata"))
+        {
+            for (const auto &Item : Object["Appdata"].items())
+                if (Item.value().is_string()) Store->Put(Prefix + "Appdata/" + Item.key(), Item.value().get<std::string>());
+        }
+
+        if (Object.contains("Languages"))
+        {
+            std::string Languages{};
+            for (const auto &Item : Object["Languages"])
+                Languages += ","s + Item.get<std::string>();
+            Store->Put(Prefix + "Languages", Languages);
+        }
+
+        if (Object.contains("DLC"))
         {
-            return ParseJSON(B2S(Filebuffer));
+            uint32_t Index{};
+            for (const auto &DLC : Object["DLC"])
+            {
+                const auto ID = DLC.value("ID", uint32_t());
+                Store->Put(va("%sDLC/%u/ID", Prefix.c_str(), Index), ID);
+                Store->Put(va("%sDLC/%u/Name", Prefix.c_str(), Index), DLC.value("Friendlyname", ""s));
+                Store->Put(va("%sDLCfile/%u", Prefix.c_str(), ID), DLC.value("Filename", ""s));
+                Index++;
+            }
+            Store->Put(Prefix + "DLCcount", Index);
         }
-        return nlohmann::json::object();
+
+        Store->Put(Prefix + "Source", Source);
+    }
+    static Kvstore_t *getAppdata()
+    {
+        static const auto Store = []()
+        {
+            const auto Temp = new Kvstore_t("./Ayria/Assets/Steam/Appdata.kv");
+            Importappdata(Temp);
+            return Temp;
+        }();
+        return Store;
+    }
+    template <typename T = std::string> static std::optional<T> getAppdata(std::string_view Key)
+    {
+        return getAppdata()->Get<T>(va("%u/", Steam.ApplicationID) + std::string(Key));
     }
 
     struct SteamApps
@@ -33,11 +91,10 @@ namespace Steam
         {
             Debugprint(va("%s: %s", __FUNCTION__, pchKey));
 
-            const auto Object = getAppdata();
-            if (!Object.contains("Appdata")) return 0;
-            if (!Object["Appdata"].contains(pchKey)) return 0;
+            const auto Value = getAppdata("Appdata/"s + pchKey);
+            if (!Value) return 0;
 
-            std::strncpy(pchValue, Object["Appdata"][pchKey].get<std::string>().c_str(), cchValueMax);
+            std::strncpy(pchValue, Value->c_str(), cchValueMax);
             return (int)std::strlen(pchValue);
         }
         bool BIsSubscribed()
@@ -65,20 +122,11 @@ namespace Steam
         }
         const char *GetAvailableGameLanguages()
         {
-            const auto Object = getAppdata();
-            if (!Object.contains("Languages")) { static auto Locale = Steam.Locale.asUTF8(); return (char *)Locale.c_str(); };
-
             static std::u8string Result{};
             if (!Result.empty()) return (char *)Result.c_str();
 
-            String_t Temp = Steam.Locale;
-            for (const auto &Item : Object["Languages"])
-            {
-                Temp += u8","s;
-                Temp += Item.get<std::u8string>();
-            }
-
-            Result = Temp.asUTF8();
+            const auto Languages = getAppdata<std::u8string>("Languages");
+            Result = Steam.Locale.asUTF8() + Languages.value_or(u8""s);
             return (char *)Result.c_str();
         }
         bool BIsSubscribedApp(uint32_t nAppID)
@@ -87,18 +135,8 @@ namespace Steam
         }
         bool BIsDlcInstalled(uint32_t nAppID)
         {
-            const auto Object = getAppdata();
-            if (!Object.contains("DLC")) return false;
-
-            for (const auto &DLC : Object["DLC"])
-            {
-                if (DLC.value("ID", uint32_t()) == nAppID)
-                {
-                    return FS::Fileexists(DLC.value("Filename", "3123123123123"));
-                }
-            }
-
-            return false;
+            const auto Filename = getAppdata(va("DLCfile/%u", nAppID));
+            return Filename && !Filename->empty() && FS::Fileexists(*Filename);
         }
         uint32_t GetEarliestPurchaseUnixTime(uint32_t nAppID)
         {
@@ -111,28 +149,17 @@ namespace Steam
         }
         int GetDLCCount()
         {
-            const auto Object = getAppdata();
-            if (!Object.contains("DLC")) return 0;
-            return (int)Object["DLC"].size();
+            return (int)getAppdata<uint32_t>("DLCcount").value_or(0);
         }
         bool BGetDLCDataByIndex(int iDLC, uint32_t *pAppID, bool *pbAvailable, char *pchName, int cchNameBufferSize)
         {
-            const auto Object = getAppdata();
-            if (!Object.contains("DLC")) return false;
+            const auto ID = getAppdata<uint32_t>(va("DLC/%i/ID", iDLC));
+            if (!ID) return false;
 
-            for (const auto &DLC : Object["DLC"])
-            {
-                if (iDLC != 0) iDLC--;
-                else
-                {
-                    *pbAvailable = true;
-                    *pAppID = DLC.value("ID", 0);
-                    std::strncpy(pchName, DLC.value("Friendlyname", "").c_str(), cchNameBufferSize);
-                    return true;
-                }
-            }
-
-            return false;
+            *pbAvailable = true;
+            *pAppID = *ID;
+            std::strncpy(pchName, getAppdata(va("DLC/%i/Name", iDLC)).value_or(""s).c_str(), cchNameBufferSize);
+            return true;
         }
         void InstallDLC(uint32_t nAppID) const
         {
@@ -19,11 +19,26 @@ namespace Steam
         return Internal;
     }
 
+    std::string Filepath(const char *Filename)
+    {
+        return Filepath() + "/" + Filename;
+    }
+
+    // Games enumerate by index, so keep a listing around rather than scanning per call.
+    // Writes are queued, so they are completed first to not list stale files.
+    std::shared_ptr<const FS::Dirsnapshot_t> Filelist()
+    {
+        static FS::Directoryindex_t Index{ Filepath() };
+        FS::Async::Flush(Filepath());
+        return Index.get();
+    }
+
     struct SteamRemotestorage
     {
         bool FileRead0(const char *filename, void *buffer, int size) const
         {
-            if(const auto Filebuffer = FS::Readfile(Filepath() + filename); !Filebuffer.empty())
+            // Ordered after any pending writes to the file.
+            if(const auto Filebuffer = FS::Async::Readfile(Filepath(filename)).get(); !Filebuffer.empty())
             {
                 std::memcpy(buffer, Filebuffer.data(), std::min(size_t(size), Filebuffer.size()));
                 return true;
@@ -32,26 +47,29 @@ namespace Steam
         }
         bool FileExists(const char *filename)
         {
-            return FS::Fileexists(Filepath() + filename);
+            FS::Async::Flush(Filepath(filename));
+            return FS::Fileexists(Filepath(filename));
         }
         bool FileDelete(const char *filename) const
         {
-            return std::remove((Filepath() + filename).c_str());
+            // A queued write would otherwise bring the file back.
+            FS::Async::Flush(Filepath(filename));
+            return 0 == std::remove(Filepath(filename).c_str());
         }
         const char *GetFileNameAndSize(int index, int *size)
         {
-            const auto Filelist = FS::Findfiles(Filepath(), "");
-            if(Filelist.size() <= index)
+            // The name needs to outlive the call, so hold on to the listing until it changes.
+            static std::shared_ptr<const FS::Dirsnapshot_t> Snapshot;
+            Snapshot = Filelist();
+
+            const auto Entry = (*Snapshot)[index];
+            if(!Entry)
             {
                 *size = 0; return nullptr;
             }
 
-            // Leaky leaky..
-            *size = uint32_t(FS::Filesize(Filelist[index]));
-            auto Leak = Filelist[index].substr(Filelist[index].find_last_of('/') + 1);
-            const auto pLeak = new char[Leak.size() + 1]();
-            std::memcpy(pLeak, Leak.data(), Leak.size());
-            return pLeak;
+            *size = int(Entry->Size);
+            return Entry->Name.c_str();
         }
         bool GetQuota(int32_t *pnTotalBytes, uint32_t *puAvailableBytes)
         {
@@ -62,14 +80,14 @@ namespace Steam
         }
         bool FileWrite(const char *pchFile, const void *pvData, int32_t cubData)
         {
-            Traceprint();
+            // Games tend to save from the game-thread, so let the IO thread deal with the disk.
+            FS::Async::Writefile(Filepath(pchFile), Blob((const uint8_t *)pvData, size_t(cubData)));
             return true;
         }
         int32_t GetFileSize(const char *pchFile)
         {
-            Traceprint();
-
-            return 0;
+            const auto Entry = Filelist()->Find(pchFile);
+            return Entry ? int32_t(Entry->Size) : 0;
         }
         int32_t FileRead1(const char *pchFile, void *pvData, int32_t cubDataToRead)
         {
@@ -79,9 +97,7 @@ namespace Steam
         }
         int32_t GetFileCount()
         {
-            Traceprint();
-
-            return 0;
+            return int32_t(Filelist()->size());
         }
         bool FilePersisted(const char *pchFile)
         {
@@ -90,9 +106,8 @@ namespace Steam
         }
         int64_t GetFileTimestamp(const char *pchFile)
         {
-            Traceprint();
-
-            return time(NULL) - 3000;
+            const auto Entry = Filelist()->Find(pchFile);
+            return Entry ? Entry->Modified : time(NULL) - 3000;
         }
         bool IsCloudEnabledForAccount()
         {
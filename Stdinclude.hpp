@@ -15,6 +15,7 @@
 // Standard-library includes for all projects in this repository.
 #include <unordered_map>
 #include <unordered_set>
+#include <condition_variable>
 #include <string_view>
 #include <filesystem>
 #include <functional>
@@ -33,6 +34,7 @@
 #include <thread>
 #include <vector>
 #include <tuple>
+#include <span>
 #include <array>
 #include <mutex>
 #include <queue>
@@ -52,6 +54,8 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/mman.h>
+#include <sys/file.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <dirent.h>
 #include <dlfcn.h>
@@ -73,12 +77,17 @@
 #include <Utilities/Encoding/Bytebuffer.hpp>
 #include <Utilities/Encoding/Stringconv.hpp>
 #include <Utilities/Encoding/Variadicstring.hpp>
+#include <Utilities/Encoding/Varint.hpp>
 #include <Utilities/Hacking/Branchless.hpp>
 #include <Utilities/Hacking/Hooking.hpp>
 #include <Utilities/Hacking/Memprotect.hpp>
 #include <Utilities/Hacking/Patternscan.hpp>
+#include <Utilities/Hacking/Patterncache.hpp>
 #include <Utilities/Wrappers/Logging.hpp>
 #include <Utilities/Wrappers/Filesystem.hpp>
+#include <Utilities/Wrappers/Asyncfile.hpp>
+#include <Utilities/Wrappers/Directoryindex.hpp>
+#include <Utilities/Wrappers/Kvstore.hpp>
 
 // Temporary includes.
 #include <Utilities/Internal/Misc.hpp>
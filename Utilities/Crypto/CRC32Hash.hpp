@@ -10,6 +10,7 @@
 
 #pragma once
 #include <Stdinclude.hpp>
+#include "../Internal/Cpufeatures.hpp"
 
 namespace Hash
 {
@@ -48,11 +49,224 @@ namespace Hash
 
             return Table;
         }
+        constexpr Array<uint32_t, 256> CRC32A_Table()
+        {
+            const uint32_t Polynomial = 0x04C11DB7;
+            Array<uint32_t, 256> Table{};
+
+            for (uint16_t i = 0; i <= 0xFF; ++i)
+            {
+                uint32_t Remainder{ uint32_t(i) << 24 };
+
+                for (uint8_t b = 8; !!b; --b)
+                {
+                    if (!(Remainder & (1UL << 31))) Remainder <<= 1;
+                    else Remainder = (Remainder << 1) ^ Polynomial;
+                }
+
+                Table[i] = Remainder;
+            }
+
+            return Table;
+        }
+
+        // Slice-by-16, Table[N][Byte] is the remainder of Byte followed by N zero-bytes.
+        constexpr Array<Array<uint32_t, 256>, 16> CRC32A_Slicingtables()
+        {
+            Array<Array<uint32_t, 256>, 16> Tables{};
+            Tables[0] = CRC32A_Table();
+
+            for (size_t n = 1; n < 16; ++n)
+                for (size_t i = 0; i < 256; ++i)
+                    Tables[n][i] = (Tables[n - 1][i] << 8) ^ Tables[0][Tables[n - 1][i] >> 24];
+
+            return Tables;
+        }
+        constexpr Array<Array<uint32_t, 256>, 16> CRC32B_Slicingtables()
+        {
+            Array<Array<uint32_t, 256>, 16> Tables{};
+            Tables[0] = CRC32B_Table();
+
+            for (size_t n = 1; n < 16; ++n)
+                for (size_t i = 0; i < 256; ++i)
+                    Tables[n][i] = (Tables[n - 1][i] >> 8) ^ Tables[0][Tables[n - 1][i] & 0xFF];
+
+            return Tables;
+        }
+        inline constexpr auto CRC32A_Slices = CRC32A_Slicingtables();
+        inline constexpr auto CRC32B_Slices = CRC32B_Slicingtables();
+
+        // Portable path, Block is the raw register (not inverted).
+        inline uint32_t CRC32A_Slicing(uint32_t Block, const uint8_t *Input, size_t Length)
+        {
+            const auto &T = CRC32A_Slices;
+
+            while (Length >= 16)
+            {
+                Block ^= (uint32_t(Input[0]) << 24) | (uint32_t(Input[1]) << 16) | (uint32_t(Input[2]) << 8) | Input[3];
+                Block = T[15][Block >> 24] ^ T[14][(Block >> 16) & 0xFF] ^ T[13][(Block >> 8) & 0xFF] ^ T[12][Block & 0xFF] ^
+                        T[11][Input[4]] ^ T[10][Input[5]] ^ T[9][Input[6]] ^ T[8][Input[7]] ^
+                        T[7][Input[8]] ^ T[6][Input[9]] ^ T[5][Input[10]] ^ T[4][Input[11]] ^
+                        T[3][Input[12]] ^ T[2][Input[13]] ^ T[1][Input[14]] ^ T[0][Input[15]];
+
+                Input += 16; Length -= 16;
+            }
+
+            while (Length--) Block = (Block << 8) ^ T[0][(Block >> 24) ^ *Input++];
+            return Block;
+        }
+        inline uint32_t CRC32B_Slicing(uint32_t Block, const uint8_t *Input, size_t Length)
+        {
+            const auto &T = CRC32B_Slices;
+
+            while (Length >= 16)
+            {
+                Block ^= uint32_t(Input[0]) | (uint32_t(Input[1]) << 8) | (uint32_t(Input[2]) << 16) | (uint32_t(Input[3]) << 24);
+                Block = T[15][Block & 0xFF] ^ T[14][(Block >> 8) & 0xFF] ^ T[13][(Block >> 16) & 0xFF] ^ T[12][Block >> 24] ^
+                        T[11][Input[4]] ^ T[10][Input[5]] ^ T[9][Input[6]] ^ T[8][Input[7]] ^
+                        T[7][Input[8]] ^ T[6][Input[9]] ^ T[5][Input[10]] ^ T[4][Input[11]] ^
+                        T[3][Input[12]] ^ T[2][Input[13]] ^ T[1][Input[14]] ^ T[0][Input[15]];
+
+                Input += 16; Length -= 16;
+            }
+
+            while (Length--) Block = (Block >> 8) ^ T[0][(Block ^ *Input++) & 0xFF];
+            return Block;
+        }
+
+        // Folding constants, x^N mod P for the MSB-first form and bit-reflected for the LSB-first form.
+        constexpr uint32_t Xpowmod(uint32_t Exponent)
+        {
+            uint64_t Remainder{ 1 };
+            while (Exponent--)
+            {
+                Remainder <<= 1;
+                if (Remainder >> 32) Remainder ^= 0x104C11DB7ULL;
+            }
+            return uint32_t(Remainder);
+        }
+        constexpr uint64_t Xpowmod_reflected(uint32_t Exponent)
+        {
+            const auto Remainder = Xpowmod(Exponent);
+            uint32_t Reflected{};
+            for (uint8_t i = 0; i < 32; ++i) if (Remainder & (1UL << i)) Reflected |= 1UL << (31 - i);
+            return uint64_t(Reflected) << 1;
+        }
+        static_assert(Xpowmod_reflected(544) == 0x154442BD4 && Xpowmod_reflected(96) == 0x0CCAA009E, "CRC32 folding constants are broken =(");
+
+        // Carry-less multiplication folds 16 bytes into the next 16, the last block is reduced with the tables.
+        TARGET_ATTR("pclmul") inline __m128i Fold_PCLMUL(__m128i Value, __m128i Constants, __m128i Data)
+        {
+            const auto Low = _mm_clmulepi64_si128(Value, Constants, 0x00);
+            const auto High = _mm_clmulepi64_si128(Value, Constants, 0x11);
+            return _mm_xor_si128(_mm_xor_si128(Low, High), Data);
+        }
+
+        // MSB-first, so the bytes are reversed to make the first byte the highest degree.
+        TARGET_ATTR("ssse3") inline __m128i Loadreversed_SSSE3(const uint8_t *Input)
+        {
+            const auto Reverse = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+            return _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)Input), Reverse);
+        }
+
+        // Length needs to be a multiple of 16 and at least 64.
+        TARGET_ATTR("pclmul,ssse3") inline uint32_t CRC32A_PCLMUL(uint32_t Block, const uint8_t *Input, size_t Length)
+        {
+            auto X0 = _mm_xor_si128(Loadreversed_SSSE3(Input), _mm_set_epi32(int(Block), 0, 0, 0));
+            auto X1 = Loadreversed_SSSE3(Input + 16), X2 = Loadreversed_SSSE3(Input + 32), X3 = Loadreversed_SSSE3(Input + 48);
+            Input += 64; Length -= 64;
+
+            constexpr int64_t K512_High = Xpowmod(512 + 64), K512_Low = Xpowmod(512);
+            const auto K512 = _mm_set_epi64x(K512_High, K512_Low);
+            while (Length >= 64)
+            {
+                X0 = Fold_PCLMUL(X0, K512, Loadreversed_SSSE3(Input));
+                X1 = Fold_PCLMUL(X1, K512, Loadreversed_SSSE3(Input + 16));
+                X2 = Fold_PCLMUL(X2, K512, Loadreversed_SSSE3(Input + 32));
+                X3 = Fold_PCLMUL(X3, K512, Loadreversed_SSSE3(Input + 48));
+                Input += 64; Length -= 64;
+            }
+
+            constexpr int64_t K128_High = Xpowmod(128 + 64), K128_Low = Xpowmod(128);
+            const auto K128 = _mm_set_epi64x(K128_High, K128_Low);
+            X0 = Fold_PCLMUL(X0, K128, X1);
+            X0 = Fold_PCLMUL(X0, K128, X2);
+            X0 = Fold_PCLMUL(X0, K128, X3);
+
+            while (Length >= 16)
+            {
+                X0 = Fold_PCLMUL(X0, K128, Loadreversed_SSSE3(Input));
+                Input += 16; Length -= 16;
+            }
+
+            alignas(16) uint8_t Remainder[16];
+            _mm_store_si128((__m128i *)Remainder, _mm_shuffle_epi8(X0, _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)));
+            return CRC32A_Slicing(0, Remainder, 16);
+        }
+        TARGET_ATTR("pclmul") inline uint32_t CRC32B_PCLMUL(uint32_t Block, const uint8_t *Input, size_t Length)
+        {
+            auto X0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)Input), _mm_cvtsi32_si128(int(Block)));
+            auto X1 = _mm_loadu_si128((const __m128i *)(Input + 16)), X2 = _mm_loadu_si128((const __m128i *)(Input + 32)), X3 = _mm_loadu_si128((const __m128i *)(Input + 48));
+            Input += 64; Length -= 64;
+
+            constexpr int64_t K512_High = Xpowmod_reflected(512 - 32), K512_Low = Xpowmod_reflected(512 + 32);
+            const auto K512 = _mm_set_epi64x(K512_High, K512_Low);
+            while (Length >= 64)
+            {
+                X0 = Fold_PCLMUL(X0, K512, _mm_loadu_si128((const __m128i *)Input));
+                X1 = Fold_PCLMUL(X1, K512, _mm_loadu_si128((const __m128i *)(Input + 16)));
+                X2 = Fold_PCLMUL(X2, K512, _mm_loadu_si128((const __m128i *)(Input + 32)));
+                X3 = Fold_PCLMUL(X3, K512, _mm_loadu_si128((const __m128i *)(Input + 48)));
+                Input += 64; Length -= 64;
+            }
+
+            constexpr int64_t K128_High = Xpowmod_reflected(128 - 32), K128_Low = Xpowmod_reflected(128 + 32);
+            const auto K128 = _mm_set_epi64x(K128_High, K128_Low);
+            X0 = Fold_PCLMUL(X0, K128, X1);
+            X0 = Fold_PCLMUL(X0, K128, X2);
+            X0 = Fold_PCLMUL(X0, K128, X3);
+
+            while (Length >= 16)
+            {
+                X0 = Fold_PCLMUL(X0, K128, _mm_loadu_si128((const __m128i *)Input));
+                Input += 16; Length -= 16;
+            }
+
+            alignas(16) uint8_t Remainder[16];
+            _mm_store_si128((__m128i *)Remainder, X0);
+            return CRC32B_Slicing(0, Remainder, 16);
+        }
+
+        // Runtime dispatch, short inputs are not worth the setup.
+        inline uint32_t CRC32A_Update(uint32_t Block, const uint8_t *Input, size_t Length)
+        {
+            if (Length >= 64 && Cpufeatures::hasPCLMUL() && Cpufeatures::hasSSSE3())
+            {
+                const auto Folded = Length & ~size_t(15);
+                Block = CRC32A_PCLMUL(Block, Input, Folded);
+                Input += Folded; Length -= Folded;
+            }
+
+            return CRC32A_Slicing(Block, Input, Length);
+        }
+        inline uint32_t CRC32B_Update(uint32_t Block, const uint8_t *Input, size_t Length)
+        {
+            if (Length >= 64 && Cpufeatures::hasPCLMUL())
+            {
+                const auto Folded = Length & ~size_t(15);
+                Block = CRC32B_PCLMUL(Block, Input, Folded);
+                Input += Folded; Length -= Folded;
+            }
+
+            return CRC32B_Slicing(Block, Input, Length);
+        }
     }
 
-    // Compile-time hashing for fixed-length datablocks.
+    // Compile-time hashing for fixed-length datablocks, runtime calls take the accelerated paths.
     [[nodiscard]] constexpr uint32_t CRC32A(const char *Input, const uint32_t Length)
     {
+        if (!std::is_constant_evaluated()) return ~Internal::CRC32A_Update(0xFFFFFFFF, (const uint8_t *)Input, Length);
+
         const uint32_t Polynomial = 0x04C11DB7;
         uint32_t Block = 0xFFFFFFFF;
 
@@ -71,6 +285,8 @@ namespace Hash
     }
     [[nodiscard]] constexpr uint32_t CRC32B(const char *Input, const uint32_t Length)
     {
+        if (!std::is_constant_evaluated()) return ~Internal::CRC32B_Update(0xFFFFFFFF, (const uint8_t *)Input, Length);
+
         uint32_t Block = 0xFFFFFFFF;
         for (uint32_t i = 0; i < Length; ++i)
         {
@@ -81,6 +297,8 @@ namespace Hash
     }
     [[nodiscard]] constexpr uint32_t CRC32T(const char *Input, const uint32_t Length)
     {
+        if (!std::is_constant_evaluated()) return ~Internal::CRC32B_Update(~Length, (const uint8_t *)Input, Length);
+
         uint32_t Block = ~Length;
         for (uint32_t i = 0; i < Length; ++i)
         {
@@ -15,6 +15,69 @@ License: MIT
 #include <openssl/rsa.h>
 #include <openssl/ssl.h>
 
+namespace Cipher
+{
+    namespace Internal
+    {
+        // Keyed once, each message only pays for the IV-setup and the cipher itself.
+        // Without an algorithm the contexts stay uninitialized and every operation fails.
+        struct Contextpair
+        {
+            EVP_CIPHER_CTX *Encryption, *Decryption;
+
+            Contextpair(const EVP_CIPHER *Algorithm, const void *Key) : Encryption(EVP_CIPHER_CTX_new()), Decryption(EVP_CIPHER_CTX_new())
+            {
+                if (!Algorithm) return;
+                EVP_EncryptInit_ex(Encryption, Algorithm, nullptr, (const uint8_t *)Key, nullptr);
+                EVP_DecryptInit_ex(Decryption, Algorithm, nullptr, (const uint8_t *)Key, nullptr);
+            }
+            Contextpair(Contextpair &&Right) noexcept : Encryption(std::exchange(Right.Encryption, nullptr)), Decryption(std::exchange(Right.Decryption, nullptr)) {}
+            Contextpair(const Contextpair &) = delete;
+            ~Contextpair()
+            {
+                if (Encryption) EVP_CIPHER_CTX_free(Encryption);
+                if (Decryption) EVP_CIPHER_CTX_free(Decryption);
+            }
+        };
+    }
+
+    // Unpadded, so the length needs to be a multiple of the block-size.
+    // Input and Output may be the same buffer for in-place operation.
+    struct CBC : Internal::Contextpair
+    {
+        size_t Blocksize;
+
+        CBC(const EVP_CIPHER *Algorithm, const void *Key) : Contextpair(Algorithm, Key), Blocksize(Algorithm ? EVP_CIPHER_block_size(Algorithm) : 0)
+        {
+            EVP_CIPHER_CTX_set_padding(Encryption, 0);
+            EVP_CIPHER_CTX_set_padding(Decryption, 0);
+        }
+
+        bool Encrypt(std::span<const uint8_t> Input, std::span<uint8_t> Output, const void *Initialvector)
+        {
+            int Written{};
+            if (!Blocksize || Output.size() < Input.size() || Input.size() % Blocksize) return false;
+            if (1 != EVP_EncryptInit_ex(Encryption, nullptr, nullptr, nullptr, (const uint8_t *)Initialvector)) return false;
+            return Input.empty() || 1 == EVP_EncryptUpdate(Encryption, Output.data(), &Written, Input.data(), int(Input.size()));
+        }
+        bool Decrypt(std::span<const uint8_t> Input, std::span<uint8_t> Output, const void *Initialvector)
+        {
+            int Written{};
+            if (!Blocksize || Output.size() < Input.size() || Input.size() % Blocksize) return false;
+            if (1 != EVP_DecryptInit_ex(Decryption, nullptr, nullptr, nullptr, (const uint8_t *)Initialvector)) return false;
+            return Input.empty() || 1 == EVP_DecryptUpdate(Decryption, Output.data(), &Written, Input.data(), int(Input.size()));
+        }
+        bool Encrypt(std::span<uint8_t> Buffer, const void *Initialvector)
+        {
+            return Encrypt(Buffer, Buffer, Initialvector);
+        }
+        bool Decrypt(std::span<uint8_t> Buffer, const void *Initialvector)
+        {
+            return Decrypt(Buffer, Buffer, Initialvector);
+        }
+    };
+}
+
 namespace AES
 {
     inline std::string Encrypt(const void *Input, const size_t Length, const void *Key, const void *Initialvector)
@@ -43,6 +106,59 @@ namespace AES
 
         return std::string((char *)Buffer.get(), Length);
     }
+
+    // Keysize in bytes selects AES-128/192/256, other sizes are rejected rather than truncated to AES-128.
+    inline const EVP_CIPHER *CBCcipher(size_t Keysize)
+    {
+        assert(Keysize == 16 || Keysize == 24 || Keysize == 32);
+        return Keysize == 32 ? EVP_aes_256_cbc() : Keysize == 24 ? EVP_aes_192_cbc() : Keysize == 16 ? EVP_aes_128_cbc() : nullptr;
+    }
+    inline const EVP_CIPHER *GCMcipher(size_t Keysize)
+    {
+        assert(Keysize == 16 || Keysize == 24 || Keysize == 32);
+        return Keysize == 32 ? EVP_aes_256_gcm() : Keysize == 24 ? EVP_aes_192_gcm() : Keysize == 16 ? EVP_aes_128_gcm() : nullptr;
+    }
+
+    struct CBC : Cipher::CBC
+    {
+        explicit CBC(const void *Key, size_t Keysize = 16) : Cipher::CBC(CBCcipher(Keysize), Key) {}
+    };
+
+    // Authenticated encryption, the IV must never repeat for the same key.
+    struct GCM : Cipher::Internal::Contextpair
+    {
+        static constexpr size_t IVsize = 12, Tagsize = 16;
+
+        explicit GCM(const void *Key, size_t Keysize = 16) : Contextpair(GCMcipher(Keysize), Key) {}
+
+        // Input and Output may be the same buffer, Additional is authenticated but not encrypted.
+        bool Encrypt(std::span<const uint8_t> Input, std::span<uint8_t> Output, std::span<const uint8_t, IVsize> Initialvector,
+                     std::span<uint8_t, Tagsize> Tag, std::span<const uint8_t> Additional = {})
+        {
+            int Written{}, Finalized{}, Authenticated{};
+            if (Output.size() < Input.size()) return false;
+            if (1 != EVP_EncryptInit_ex(Encryption, nullptr, nullptr, nullptr, Initialvector.data())) return false;
+            if (!Additional.empty() && 1 != EVP_EncryptUpdate(Encryption, nullptr, &Authenticated, Additional.data(), int(Additional.size()))) return false;
+            if (!Input.empty() && 1 != EVP_EncryptUpdate(Encryption, Output.data(), &Written, Input.data(), int(Input.size()))) return false;
+            if (1 != EVP_EncryptFinal_ex(Encryption, Output.data() + Written, &Finalized)) return false;
+
+            return 1 == EVP_CIPHER_CTX_ctrl(Encryption, EVP_CTRL_GCM_GET_TAG, int(Tagsize), Tag.data());
+        }
+
+        // On failure the output is unauthenticated and should be discarded.
+        bool Decrypt(std::span<const uint8_t> Input, std::span<uint8_t> Output, std::span<const uint8_t, IVsize> Initialvector,
+                     std::span<const uint8_t, Tagsize> Tag, std::span<const uint8_t> Additional = {})
+        {
+            int Written{}, Finalized{}, Authenticated{};
+            if (Output.size() < Input.size()) return false;
+            if (1 != EVP_DecryptInit_ex(Decryption, nullptr, nullptr, nullptr, Initialvector.data())) return false;
+            if (!Additional.empty() && 1 != EVP_DecryptUpdate(Decryption, nullptr, &Authenticated, Additional.data(), int(Additional.size()))) return false;
+            if (!Input.empty() && 1 != EVP_DecryptUpdate(Decryption, Output.data(), &Written, Input.data(), int(Input.size()))) return false;
+            if (1 != EVP_CIPHER_CTX_ctrl(Decryption, EVP_CTRL_GCM_SET_TAG, int(Tagsize), (void *)Tag.data())) return false;
+
+            return 1 == EVP_DecryptFinal_ex(Decryption, Output.data() + Written, &Finalized);
+        }
+    };
 }
 
 namespace DES3
@@ -73,61 +189,190 @@ namespace DES3
 
         return std::string((char *)Buffer.get(), Length);
     }
+
+    struct CBC : Cipher::CBC
+    {
+        explicit CBC(const void *Key) : Cipher::CBC(EVP_des_ede3_cbc(), Key) {}
+    };
 }
 
 namespace Hash
 {
-    inline std::string SHA1(const void *Input, const size_t Size)
+    namespace Internal
     {
-        const auto Buffer = std::make_unique<uint8_t[]>(20);
-        const auto Context = EVP_MD_CTX_create();
+        // Keeps the context alive between messages, Finalize resets it for the next one.
+        template <size_t Size> struct Digeststream
+        {
+            static constexpr size_t Digestsize = Size;
+            EVP_MD_CTX *Context;
+
+            explicit Digeststream(const EVP_MD *Digest) : Context(EVP_MD_CTX_create())
+            {
+                EVP_DigestInit_ex(Context, Digest, nullptr);
+            }
+            Digeststream(Digeststream &&Right) noexcept : Context(std::exchange(Right.Context, nullptr)) {}
+            Digeststream(const Digeststream &) = delete;
+            ~Digeststream() { if (Context) EVP_MD_CTX_destroy(Context); }
+
+            void Update(const void *Input, const size_t Length)
+            {
+                EVP_DigestUpdate(Context, Input, Length);
+            }
+            void Update(std::span<const uint8_t> Input)
+            {
+                Update(Input.data(), Input.size());
+            }
+            void Update(std::string_view Input)
+            {
+                Update(Input.data(), Input.size());
+            }
+
+            // A null type re-initializes with the bound digest, which skips the lookup.
+            void Finalize(std::span<uint8_t, Size> Output)
+            {
+                EVP_DigestFinal_ex(Context, Output.data(), nullptr);
+                EVP_DigestInit_ex(Context, nullptr, nullptr);
+            }
+            std::array<uint8_t, Size> Finalize()
+            {
+                std::array<uint8_t, Size> Output;
+                Finalize(Output);
+                return Output;
+            }
+        };
+
+        // The key is kept between messages, setKey replaces it.
+        template <size_t Size> struct HMACstream
+        {
+            static constexpr size_t Digestsize = Size;
+            HMAC_CTX *Context;
+
+            // A null key means reuse to OpenSSL, so empty keys are passed as "".
+            HMACstream(const EVP_MD *Digest, const void *Key, const size_t Keysize) : Context(HMAC_CTX_new())
+            {
+                HMAC_Init_ex(Context, Key ? Key : "", int(Keysize), Digest, nullptr);
+            }
+            HMACstream(HMACstream &&Right) noexcept : Context(std::exchange(Right.Context, nullptr)) {}
+            HMACstream(const HMACstream &) = delete;
+            ~HMACstream() { if (Context) HMAC_CTX_free(Context); }
+
+            void setKey(const void *Key, const size_t Keysize)
+            {
+                HMAC_Init_ex(Context, Key ? Key : "", int(Keysize), nullptr, nullptr);
+            }
+
+            void Update(const void *Input, const size_t Length)
+            {
+                HMAC_Update(Context, (const uint8_t *)Input, Length);
+            }
+            void Update(std::span<const uint8_t> Input)
+            {
+                Update(Input.data(), Input.size());
+            }
+            void Update(std::string_view Input)
+            {
+                Update(Input.data(), Input.size());
+            }
+
+            void Finalize(std::span<uint8_t, Size> Output)
+            {
+                unsigned int Outputsize = Size;
+                HMAC_Final(Context, Output.data(), &Outputsize);
+                HMAC_Init_ex(Context, nullptr, 0, nullptr, nullptr);
+            }
+            std::array<uint8_t, Size> Finalize()
+            {
+                std::array<uint8_t, Size> Output;
+                Finalize(Output);
+                return Output;
+            }
+        };
+    }
+
+    // Streaming digests, reusable after Finalize.
+    struct SHA1stream : Internal::Digeststream<20> { SHA1stream() : Digeststream(EVP_sha1()) {} };
+    struct SHA256stream : Internal::Digeststream<32> { SHA256stream() : Digeststream(EVP_sha256()) {} };
+    struct MD5stream : Internal::Digeststream<16> { MD5stream() : Digeststream(EVP_md5()) {} };
+    struct HMACSHA1stream : Internal::HMACstream<20> { HMACSHA1stream(const void *Key = nullptr, const size_t Keysize = 0) : HMACstream(EVP_sha1(), Key, Keysize) {} };
+    struct HMACSHA256stream : Internal::HMACstream<32> { HMACSHA256stream(const void *Key = nullptr, const size_t Keysize = 0) : HMACstream(EVP_sha256(), Key, Keysize) {} };
+
+    namespace Internal
+    {
+        // One context per thread for the one-shot helpers.
+        template <typename Stream> Stream &Cachedstream()
+        {
+            thread_local Stream Instance{};
+            return Instance;
+        }
 
-        EVP_DigestInit_ex(Context, EVP_sha1(), nullptr);
-        EVP_DigestUpdate(Context, Input, Size);
-        EVP_DigestFinal_ex(Context, Buffer.get(), nullptr);
-        EVP_MD_CTX_destroy(Context);
+        template <typename Stream> void Digest(const void *Input, const size_t Size, std::span<uint8_t, Stream::Digestsize> Output)
+        {
+            auto &Context = Cachedstream<Stream>();
+            Context.Update(Input, Size);
+            Context.Finalize(Output);
+        }
+        template <typename Stream> std::string Digest(const void *Input, const size_t Size)
+        {
+            uint8_t Buffer[Stream::Digestsize];
+            Digest<Stream>(Input, Size, Buffer);
+            return std::string((char *)Buffer, sizeof(Buffer));
+        }
+        template <typename Stream> void HMAC(const void *Input, const size_t Size, const void *Key, const size_t Keysize, std::span<uint8_t, Stream::Digestsize> Output)
+        {
+            auto &Context = Cachedstream<Stream>();
+            Context.setKey(Key, Keysize);
+            Context.Update(Input, Size);
+            Context.Finalize(Output);
+        }
+        template <typename Stream> std::string HMAC(const void *Input, const size_t Size, const void *Key, const size_t Keysize)
+        {
+            uint8_t Buffer[Stream::Digestsize];
+            HMAC<Stream>(Input, Size, Key, Keysize, Buffer);
+            return std::string((char *)Buffer, sizeof(Buffer));
+        }
+    }
 
-        return std::string((char *)Buffer.get(), 20);
+    inline std::string SHA1(const void *Input, const size_t Size)
+    {
+        return Internal::Digest<SHA1stream>(Input, Size);
     }
     inline std::string SHA256(const void *Input, const size_t Size)
     {
-        const auto Buffer = std::make_unique<uint8_t[]>(32);
-        const auto Context = EVP_MD_CTX_create();
-
-        EVP_DigestInit_ex(Context, EVP_sha256(), nullptr);
-        EVP_DigestUpdate(Context, Input, Size);
-        EVP_DigestFinal_ex(Context, Buffer.get(), nullptr);
-        EVP_MD_CTX_destroy(Context);
-
-        return std::string((char *)Buffer.get(), 32);
+        return Internal::Digest<SHA256stream>(Input, Size);
     }
     inline std::string HMACSHA1(const void *Input, const size_t Size, const void *Key, const size_t Keysize)
     {
-        unsigned char Buffer[256]{};
-        unsigned int Buffersize = 256;
-
-        HMAC(EVP_sha1(), Key, uint32_t(Keysize), (uint8_t *)Input, Size, Buffer, &Buffersize);
-        return std::string((char *)Buffer, Buffersize);
+        return Internal::HMAC<HMACSHA1stream>(Input, Size, Key, Keysize);
     }
     inline std::string HMACSHA256(const void *Input, const size_t Size, const void *Key, const size_t Keysize)
     {
-        unsigned char Buffer[256]{};
-        unsigned int Buffersize = 256;
-
-        HMAC(EVP_sha256(), Key, uint32_t(Keysize), (uint8_t *)Input, Size, Buffer, &Buffersize);
-        return std::string((char *)Buffer, Buffersize);
+        return Internal::HMAC<HMACSHA256stream>(Input, Size, Key, Keysize);
     }
     inline std::string MD5(const void *Input, const size_t Size)
     {
-        const auto Buffer = std::make_unique<uint8_t[]>(16);
-        const auto Context = EVP_MD_CTX_create();
-
-        EVP_DigestInit_ex(Context, EVP_md5(), nullptr);
-        EVP_DigestUpdate(Context, Input, Size);
-        EVP_DigestFinal_ex(Context, Buffer.get(), nullptr);
-        EVP_MD_CTX_destroy(Context);
+        return Internal::Digest<MD5stream>(Input, Size);
+    }
 
-        return std::string((char *)Buffer.get(), 16);
+    // Allocation-free versions writing to a fixed-size buffer.
+    inline void SHA1(const void *Input, const size_t Size, std::span<uint8_t, 20> Output)
+    {
+        Internal::Digest<SHA1stream>(Input, Size, Output);
+    }
+    inline void SHA256(const void *Input, const size_t Size, std::span<uint8_t, 32> Output)
+    {
+        Internal::Digest<SHA256stream>(Input, Size, Output);
+    }
+    inline void HMACSHA1(const void *Input, const size_t Size, const void *Key, const size_t Keysize, std::span<uint8_t, 20> Output)
+    {
+        Internal::HMAC<HMACSHA1stream>(Input, Size, Key, Keysize, Output);
+    }
+    inline void HMACSHA256(const void *Input, const size_t Size, const void *Key, const size_t Keysize, std::span<uint8_t, 32> Output)
+    {
+        Internal::HMAC<HMACSHA256stream>(Input, Size, Key, Keysize, Output);
+    }
+    inline void MD5(const void *Input, const size_t Size, std::span<uint8_t, 16> Output)
+    {
+        Internal::Digest<MD5stream>(Input, Size, Output);
     }
 }
 
@@ -156,14 +401,24 @@ namespace PK_RSA
         return Createkeypair(std::basic_string_view<T>(Privatekey.data(), Privatekey.size()));
     }
 
-    template <typename T> inline std::string Signmessage(std::basic_string_view<T> Input, RSA *Key)
+    // DER-encoded public key to a reusable EVP key, caller frees with EVP_PKEY_free.
+    inline EVP_PKEY *Parsepublickey(std::string_view Publickey)
+    {
+        const auto Keypointer = Publickey.data();
+        const auto Key = d2i_RSA_PUBKEY(NULL, (const uint8_t **)&Keypointer, (long)Publickey.size());
+        if (!Key) return nullptr;
+
+        const auto Result = EVP_PKEY_new();
+        EVP_PKEY_assign_RSA(Result, Key);
+        return Result;
+    }
+
+    template <typename T> inline std::string Signmessage(std::basic_string_view<T> Input, EVP_PKEY *Key)
     {
         EVP_MD_CTX *Context = EVP_MD_CTX_create();
-        EVP_PKEY *Privatekey = EVP_PKEY_new();
-        EVP_PKEY_assign_RSA(Privatekey, Key);
 
         EVP_PKEY_CTX *pkeyCtx;
-        EVP_DigestSignInit(Context, &pkeyCtx, EVP_sha256(), nullptr, Privatekey);
+        EVP_DigestSignInit(Context, &pkeyCtx, EVP_sha256(), nullptr, Key);
         EVP_PKEY_CTX_set_rsa_padding(pkeyCtx, RSA_PKCS1_PSS_PADDING);
         EVP_PKEY_CTX_set_rsa_pss_saltlen(pkeyCtx, 0);
         EVP_DigestSignUpdate(Context, Input.data(), Input.size());
@@ -176,23 +431,33 @@ namespace PK_RSA
 
         return Signature;
     }
+    template <typename T> inline std::string Signmessage(std::basic_string_view<T> Input, RSA *Key)
+    {
+        // The wrapper takes its own reference, so the callers key outlives it.
+        EVP_PKEY *Privatekey = EVP_PKEY_new();
+        EVP_PKEY_set1_RSA(Privatekey, Key);
+
+        const auto Result = Signmessage(Input, Privatekey);
+        EVP_PKEY_free(Privatekey);
+        return Result;
+    }
     template <typename T> inline std::string Signmessage(const std::basic_string<T> &Input, RSA *Key)
     {
         return Signmessage(std::basic_string_view<T>(Input.data(), Input.size()), Key);
     }
+    template <typename T> inline std::string Signmessage(const std::basic_string<T> &Input, EVP_PKEY *Key)
+    {
+        return Signmessage(std::basic_string_view<T>(Input.data(), Input.size()), Key);
+    }
 
-    template <typename T> inline bool Verifysignature(std::basic_string_view<T> Input, std::basic_string_view<T> Signature, RSA *Key)
+    template <typename T> inline bool Verifysignature(std::basic_string_view<T> Input, std::basic_string_view<T> Signature, EVP_PKEY *Key)
     {
         EVP_MD_CTX *Context = EVP_MD_CTX_create();
-        EVP_PKEY *Publickey = EVP_PKEY_new();
-        EVP_PKEY_assign_RSA(Publickey, Key);
 
         EVP_PKEY_CTX *pkeyCtx;
-        EVP_DigestSignInit(Context, &pkeyCtx, EVP_sha256(), nullptr, Publickey);
+        EVP_DigestVerifyInit(Context, &pkeyCtx, EVP_sha256(), nullptr, Key);
         EVP_PKEY_CTX_set_rsa_padding(pkeyCtx, RSA_PKCS1_PSS_PADDING);
         EVP_PKEY_CTX_set_rsa_pss_saltlen(pkeyCtx, 0);
-
-        EVP_DigestVerifyInit(Context, &pkeyCtx, EVP_sha256(), nullptr, Publickey);
         EVP_DigestVerifyUpdate(Context, Input.data(), Input.size());
 
         const auto Result = 1 == EVP_DigestVerifyFinal(Context, (uint8_t *)Signature.data(), Signature.size());
@@ -200,17 +465,31 @@ namespace PK_RSA
         EVP_MD_CTX_destroy(Context);
         return Result;
     }
+    template <typename T> inline bool Verifysignature(std::basic_string_view<T> Input, std::basic_string_view<T> Signature, RSA *Key)
+    {
+        EVP_PKEY *Publickey = EVP_PKEY_new();
+        EVP_PKEY_set1_RSA(Publickey, Key);
+
+        const auto Result = Verifysignature(Input, Signature, Publickey);
+        EVP_PKEY_free(Publickey);
+        return Result;
+    }
     template <typename T> inline bool Verifysignature(const std::basic_string<T> &Input, const std::basic_string<T> &Signature, RSA *Key)
     {
         return Verifysignature(std::basic_string_view<T>(Input.data(), Input.size()), std::basic_string_view<T>(Signature.data(), Signature.size()), Key);
     }
+    template <typename T> inline bool Verifysignature(const std::basic_string<T> &Input, const std::basic_string<T> &Signature, EVP_PKEY *Key)
+    {
+        return Verifysignature(std::basic_string_view<T>(Input.data(), Input.size()), std::basic_string_view<T>(Signature.data(), Signature.size()), Key);
+    }
     template <typename T> inline bool Verifysignature(const std::basic_string<T> &Input, const std::basic_string<T> &Signature, std::string_view Publickey)
     {
-        const auto Keypointer = Publickey.data();
-        const auto Key = d2i_RSA_PUBKEY(NULL, (const uint8_t **)&Keypointer, (long)Publickey.size());
+        const auto Key = Parsepublickey(Publickey);
         if (!Key) return false;
 
-        return Verifysignature(std::basic_string_view<T>(Input.data(), Input.size()), std::basic_string_view<T>(Signature.data(), Signature.size()), Key);
+        const auto Result = Verifysignature(Input, Signature, Key);
+        EVP_PKEY_free(Key);
+        return Result;
     }
 
     template <typename T> inline std::string Encrypt(std::basic_string_view<T> Input, RSA *Key)
@@ -231,13 +510,29 @@ namespace PK_RSA
 
         return Result;
     }
+    template <typename T> inline std::string Encrypt(std::basic_string_view<T> Input, EVP_PKEY *Key)
+    {
+        const auto RSAKey = (RSA *)EVP_PKEY_get0_RSA(Key);
+        if (!RSAKey) return "";
+
+        return Encrypt(Input, RSAKey);
+    }
+    template <typename T> inline std::string Decrypt(std::basic_string_view<T> Input, EVP_PKEY *Key)
+    {
+        const auto RSAKey = (RSA *)EVP_PKEY_get0_RSA(Key);
+        if (!RSAKey) return "";
+
+        return Decrypt(Input, RSAKey);
+    }
     template <typename T> inline std::string Encrypt(std::basic_string_view<T> Input, std::string_view Publickey)
     {
         const auto Keypointer = Publickey.data();
         const auto Key = d2i_RSA_PUBKEY(NULL, (const uint8_t **)&Keypointer, (long)Publickey.size());
         if (!Key) return "";    // WTF?
 
-        return Encrypt(Input, Key);
+        const auto Result = Encrypt(Input, Key);
+        RSA_free(Key);
+        return Result;
     }
     template <typename T> inline std::string Decrypt(std::basic_string_view<T> Input, std::string_view Privatekey)
     {
@@ -245,7 +540,9 @@ namespace PK_RSA
         const auto Key = d2i_RSAPrivateKey(NULL, (const uint8_t **)&Keypointer, (long)Privatekey.size());
         if (!Key) return "";    // WTF?
 
-        return Decrypt(Input, Key);
+        const auto Result = Decrypt(Input, Key);
+        RSA_free(Key);
+        return Result;
     }
 
     template <typename T> inline std::string Encrypt(const std::basic_string<T> &Input, RSA *Key)
@@ -256,6 +553,14 @@ namespace PK_RSA
     {
         return Decrypt(std::basic_string_view<T>(Input.data(), Input.size()), Key);
     }
+    template <typename T> inline std::string Encrypt(const std::basic_string<T> &Input, EVP_PKEY *Key)
+    {
+        return Encrypt(std::basic_string_view<T>(Input.data(), Input.size()), Key);
+    }
+    template <typename T> inline std::string Decrypt(const std::basic_string<T> &Input, EVP_PKEY *Key)
+    {
+        return Decrypt(std::basic_string_view<T>(Input.data(), Input.size()), Key);
+    }
     template <typename T> inline std::string Encrypt(const std::basic_string<T> &Input, std::string_view Publickey)
     {
         return Encrypt(std::basic_string_view<T>(Input.data(), Input.size()), Publickey);
@@ -379,6 +684,157 @@ namespace PK_ECC
         BIO_free_all(Bio);
         return Result;
     }
+    inline EC_KEY *Parsepublickey(std::string_view Publickey)
+    {
+        const auto Keypointer = Publickey.data();
+        return d2i_EC_PUBKEY(NULL, (const uint8_t **)&Keypointer, (long)Publickey.size());
+    }
+
+    // ECDH, both parties arrive at the same secret. Keys need to be on the same curve.
+    inline std::string Sharedsecret(const EC_KEY *Privatekey, const EC_KEY *Peerkey)
+    {
+        const auto Group = EC_KEY_get0_group(Privatekey);
+        std::string Result; Result.resize((EC_GROUP_get_degree(Group) + 7) / 8);
+
+        const auto Length = ECDH_compute_key(Result.data(), Result.size(), EC_KEY_get0_public_key(Peerkey), Privatekey, nullptr);
+        if (Length <= 0) return {};
+
+        Result.resize(Length);
+        return Result;
+    }
+
+    // The raw secret is not uniformly distributed, so hash it before use as a symmetric key.
+    inline bool Derivekey(const EC_KEY *Privatekey, const EC_KEY *Peerkey, std::span<uint8_t, 32> Output)
+    {
+        const auto Secret = Sharedsecret(Privatekey, Peerkey);
+        if (Secret.empty()) return false;
+
+        Hash::SHA256(Secret.data(), Secret.size(), Output);
+        OPENSSL_cleanse((void *)Secret.data(), Secret.size());
+        return true;
+    }
+}
+
+namespace PK_Ed25519
+{
+    inline EVP_PKEY *Createkeypair()
+    {
+        EVP_PKEY *Key{};
+        const auto Context = EVP_PKEY_CTX_new_id(EVP_PKEY_ED25519, nullptr);
+        if (1 == EVP_PKEY_keygen_init(Context)) EVP_PKEY_keygen(Context, &Key);
+
+        EVP_PKEY_CTX_free(Context);
+        return Key;
+    }
+
+    // Ed25519 hashes internally, so it only supports one-shot signing.
+    inline std::string Signmessage(std::string_view Input, EVP_PKEY *Key)
+    {
+        EVP_MD_CTX *Context = EVP_MD_CTX_create();
+        std::string Signature{}; Signature.resize(64);
+        size_t Signaturelength{ Signature.size() };
+
+        if (1 != EVP_DigestSignInit(Context, nullptr, nullptr, nullptr, Key) ||
+            1 != EVP_DigestSign(Context, (uint8_t *)Signature.data(), &Signaturelength, (const uint8_t *)Input.data(), Input.size()))
+            Signaturelength = 0;
+
+        EVP_MD_CTX_destroy(Context);
+        Signature.resize(Signaturelength);
+        return Signature;
+    }
+    inline bool Verifysignature(std::string_view Input, std::string_view Signature, EVP_PKEY *Key)
+    {
+        EVP_MD_CTX *Context = EVP_MD_CTX_create();
+
+        const auto Result = 1 == EVP_DigestVerifyInit(Context, nullptr, nullptr, nullptr, Key) &&
+            1 == EVP_DigestVerify(Context, (const uint8_t *)Signature.data(), Signature.size(), (const uint8_t *)Input.data(), Input.size());
+
+        EVP_MD_CTX_destroy(Context);
+        return Result;
+    }
+
+    inline std::string getPublickey(EVP_PKEY *Key)
+    {
+        const auto Bio = BIO_new(BIO_s_mem());
+        i2d_PUBKEY_bio(Bio, Key);
+
+        const auto Length = BIO_pending(Bio);
+        std::string Result; Result.resize(Length);
+        BIO_read(Bio, Result.data(), Length);
+
+        BIO_free_all(Bio);
+        return Result;
+    }
+    inline EVP_PKEY *Parsepublickey(std::string_view Publickey)
+    {
+        const auto Keypointer = Publickey.data();
+        const auto Key = d2i_PUBKEY(NULL, (const uint8_t **)&Keypointer, (long)Publickey.size());
+        if (Key && EVP_PKEY_id(Key) != EVP_PKEY_ED25519)
+        {
+            EVP_PKEY_free(Key);
+            return nullptr;
+        }
+
+        return Key;
+    }
+}
+
+// Dispatches on the key-type, so callers need not care which scheme a peer signs with.
+namespace PK_Signature
+{
+    inline std::string Signmessage(std::string_view Input, EVP_PKEY *Key)
+    {
+        switch (EVP_PKEY_id(Key))
+        {
+            case EVP_PKEY_ED25519: return PK_Ed25519::Signmessage(Input, Key);
+            case EVP_PKEY_RSA: return PK_RSA::Signmessage(Input, Key);
+            default: return {};
+        }
+    }
+    inline bool Verifysignature(std::string_view Input, std::string_view Signature, EVP_PKEY *Key)
+    {
+        switch (EVP_PKEY_id(Key))
+        {
+            case EVP_PKEY_ED25519: return PK_Ed25519::Verifysignature(Input, Signature, Key);
+            case EVP_PKEY_RSA: return PK_RSA::Verifysignature(Input, Signature, Key);
+            default: return false;
+        }
+    }
+
+    // Verifies a whole batch with a single context, returns the number of valid signatures.
+    struct Batchitem_t { std::string_view Input, Signature; EVP_PKEY *Key; bool isValid; };
+    inline size_t Verifybatch(std::span<Batchitem_t> Items)
+    {
+        EVP_MD_CTX *Context = EVP_MD_CTX_create();
+        size_t Validcount{};
+
+        for (auto &Item : Items)
+        {
+            Item.isValid = false;
+            EVP_MD_CTX_reset(Context);
+
+            if (EVP_PKEY_id(Item.Key) == EVP_PKEY_ED25519)
+            {
+                Item.isValid = 1 == EVP_DigestVerifyInit(Context, nullptr, nullptr, nullptr, Item.Key) &&
+                    1 == EVP_DigestVerify(Context, (const uint8_t *)Item.Signature.data(), Item.Signature.size(),
+                                          (const uint8_t *)Item.Input.data(), Item.Input.size());
+            }
+            else if (EVP_PKEY_id(Item.Key) == EVP_PKEY_RSA)
+            {
+                EVP_PKEY_CTX *pkeyCtx;
+                Item.isValid = 1 == EVP_DigestVerifyInit(Context, &pkeyCtx, EVP_sha256(), nullptr, Item.Key) &&
+                    0 < EVP_PKEY_CTX_set_rsa_padding(pkeyCtx, RSA_PKCS1_PSS_PADDING) &&
+                    0 < EVP_PKEY_CTX_set_rsa_pss_saltlen(pkeyCtx, 0) &&
+                    1 == EVP_DigestVerifyUpdate(Context, Item.Input.data(), Item.Input.size()) &&
+                    1 == EVP_DigestVerifyFinal(Context, (const uint8_t *)Item.Signature.data(), Item.Signature.size());
+            }
+
+            Validcount += Item.isValid;
+        }
+
+        EVP_MD_CTX_destroy(Context);
+        return Validcount;
+    }
 }
 
 #endif
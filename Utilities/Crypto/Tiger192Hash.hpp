@@ -738,6 +738,188 @@ namespace Hash
             State.nblocks = 0;
             State.count = 0;
         }
+
+        // Independent lanes interleaved round by round, the S-box lookups of one lane hide the latency of the others.
+        template <size_t Lanes> inline void tiger_pass_lanes(uint64_t *a, uint64_t *b, uint64_t *c, uint64_t (*x)[8], int mul)
+        {
+            const auto Round = [&](uint64_t *ra, uint64_t *rb, uint64_t *rc, size_t i)
+            {
+                for (size_t l = 0; l < Lanes; ++l) tiger_round(&ra[l], &rb[l], &rc[l], x[l][i], mul);
+            };
+
+            Round(a, b, c, 0);
+            Round(b, c, a, 1);
+            Round(c, a, b, 2);
+            Round(a, b, c, 3);
+            Round(b, c, a, 4);
+            Round(c, a, b, 5);
+            Round(a, b, c, 6);
+            Round(b, c, a, 7);
+        }
+        template <size_t Lanes> inline void tiger_transform_lanes(const uint8_t *const *Data, tiger_state *const *States)
+        {
+            uint64_t a[Lanes], b[Lanes], c[Lanes], x[Lanes][8];
+
+            for (size_t l = 0; l < Lanes; ++l)
+            {
+                std::memcpy(x[l], Data[l], 64);
+                a[l] = States[l]->a;
+                b[l] = States[l]->b;
+                c[l] = States[l]->c;
+            }
+
+            tiger_pass_lanes<Lanes>(a, b, c, x, 5);
+            for (size_t l = 0; l < Lanes; ++l) tiger_key_schedule(x[l]);
+            tiger_pass_lanes<Lanes>(c, a, b, x, 7);
+            for (size_t l = 0; l < Lanes; ++l) tiger_key_schedule(x[l]);
+            tiger_pass_lanes<Lanes>(b, c, a, x, 9);
+
+            for (size_t l = 0; l < Lanes; ++l)
+            {
+                States[l]->a ^= a[l];
+                States[l]->b = b[l] - States[l]->b;
+                States[l]->c += c[l];
+                States[l]->nblocks++;
+            }
+        }
+
+        // All lanes need to be at the same position in their streams, e.g. freshly initialized.
+        template <size_t Lanes> inline void tiger_write_lanes(const uint8_t *const *Inputs, size_t Length, tiger_state *const *States)
+        {
+            const uint8_t *Offsets[Lanes];
+            const uint8_t *Buffers[Lanes];
+
+            for (size_t l = 0; l < Lanes; ++l)
+            {
+                tiger_write(nullptr, 0, *States[l]);
+                Buffers[l] = States[l]->buf;
+                Offsets[l] = Inputs[l];
+            }
+
+            // Complete the buffered block first.
+            if (const auto Count = size_t(States[0]->count))
+            {
+                const auto Fill = std::min(64 - Count, Length);
+                for (size_t l = 0; l < Lanes; ++l)
+                {
+                    std::memcpy(States[l]->buf + Count, Offsets[l], Fill);
+                    States[l]->count += int(Fill);
+                    Offsets[l] += Fill;
+                }
+
+                Length -= Fill;
+                if (Count + Fill < 64) return;
+
+                tiger_transform_lanes<Lanes>(Buffers, States);
+                for (size_t l = 0; l < Lanes; ++l) States[l]->count = 0;
+            }
+
+            while (Length >= 64)
+            {
+                tiger_transform_lanes<Lanes>(Offsets, States);
+                for (size_t l = 0; l < Lanes; ++l) Offsets[l] += 64;
+                Length -= 64;
+            }
+
+            for (size_t l = 0; l < Lanes; ++l)
+            {
+                std::memcpy(States[l]->buf, Offsets[l], Length);
+                States[l]->count = int(Length);
+            }
+        }
+
+        // tiger_write takes an int, so larger inputs are split.
+        inline void tiger_write_large(const uint8_t *Input, size_t Size, tiger_state &State)
+        {
+            constexpr size_t Stepsize = size_t(1) << 30;
+
+            while (Size > Stepsize)
+            {
+                tiger_write(Input, int(Stepsize), State);
+                Input += Stepsize;
+                Size -= Stepsize;
+            }
+
+            tiger_write(Input, int(Size), State);
+        }
+
+        // Reverse the blocks because libtom likes them that way..
+        inline std::string tiger_digest(tiger_state &State)
+        {
+            uint64_t Blocks[3];
+            std::memcpy(Blocks, tiger_final(State), 24);
+
+            Blocks[0] = _byteswap_uint64(Blocks[0]);
+            Blocks[1] = _byteswap_uint64(Blocks[1]);
+            Blocks[2] = _byteswap_uint64(Blocks[2]);
+
+            return std::string((const char *)Blocks, 24);
+        }
+
+        // THEX nodes are the two children prefixed with 0x01, combined level by level and an odd node is promoted as is.
+        inline std::string tigertree_combine(std::vector<std::string> &Nodes)
+        {
+            constexpr uint8_t Nodeprefix = 0x01;
+
+            while (Nodes.size() > 1)
+            {
+                size_t Written{};
+                for (size_t i = 0; i + 1 < Nodes.size(); i += 2)
+                {
+                    tiger_state State;
+                    tiger_init(State);
+                    tiger_write(&Nodeprefix, 1, State);
+                    tiger_write((const uint8_t *)Nodes[i].data(), 24, State);
+                    tiger_write((const uint8_t *)Nodes[i + 1].data(), 24, State);
+                    Nodes[Written++] = tiger_digest(State);
+                }
+
+                if (Nodes.size() & 1) Nodes[Written++] = std::move(Nodes.back());
+                Nodes.resize(Written);
+            }
+
+            return std::move(Nodes.front());
+        }
+
+        // THEX leaves are 1024 bytes prefixed with 0x00.
+        inline void tigertree_subtree(const uint8_t *Input, size_t Size, std::string &Output)
+        {
+            constexpr size_t Leafsize = 1024;
+            constexpr uint8_t Leafprefix = 0x00;
+            const size_t Leafcount = std::max(size_t(1), (Size + Leafsize - 1) / Leafsize);
+
+            std::vector<std::string> Nodes;
+            Nodes.reserve(Leafcount);
+
+            // Full leaves four at a time.
+            size_t Leaf{};
+            for (; Leaf + 4 <= Leafcount && (Leaf + 4) * Leafsize <= Size; Leaf += 4)
+            {
+                tiger_state States[4];
+                tiger_state *Pointers[4]{ &States[0], &States[1], &States[2], &States[3] };
+                const uint8_t *Inputs[4]{ Input + Leaf * Leafsize, Input + (Leaf + 1) * Leafsize, Input + (Leaf + 2) * Leafsize, Input + (Leaf + 3) * Leafsize };
+
+                for (auto &State : States)
+                {
+                    tiger_init(State);
+                    tiger_write(&Leafprefix, 1, State);
+                }
+
+                tiger_write_lanes<4>(Inputs, Leafsize, Pointers);
+                for (auto &State : States) Nodes.emplace_back(tiger_digest(State));
+            }
+
+            for (; Leaf < Leafcount; ++Leaf)
+            {
+                tiger_state State;
+                tiger_init(State);
+                tiger_write(&Leafprefix, 1, State);
+                tiger_write(Input + Leaf * Leafsize, int(std::min(Leafsize, Size - std::min(Size, Leaf * Leafsize))), State);
+                Nodes.emplace_back(tiger_digest(State));
+            }
+
+            Output = tigertree_combine(Nodes);
+        }
     }
 
     inline void Tiger192(const void *Input, const size_t Size, uint8_t Output[24])
@@ -745,25 +927,104 @@ namespace Hash
         Internal::tiger_state State;
 
         Internal::tiger_init(State);
-        Internal::tiger_write((uint8_t *)Input, static_cast<const int>(Size), State);
+        Internal::tiger_write_large((const uint8_t *)Input, Size, State);
         std::memcpy(Output, Internal::tiger_final(State), 24);
     }
     inline std::string Tiger192(const void *Input, const size_t Size)
     {
-        std::string Resultstring;
-        uint8_t Resultbuffer[24]{};
+        Internal::tiger_state State;
 
-        // Hash the input.
-        Tiger192(Input, Size, Resultbuffer);
+        Internal::tiger_init(State);
+        Internal::tiger_write_large((const uint8_t *)Input, Size, State);
+        return Internal::tiger_digest(State);
+    }
 
-        // Reverse the blocks because libtom likes them that way..
-        auto *Blocks = reinterpret_cast<uint64_t *>(Resultbuffer);
-        Blocks[0] = _byteswap_uint64(Blocks[0]);
-        Blocks[1] = _byteswap_uint64(Blocks[1]);
-        Blocks[2] = _byteswap_uint64(Blocks[2]);
+    // Incremental hashing, e.g. for files read in chunks.
+    struct Tiger192stream
+    {
+        Internal::tiger_state State;
+
+        Tiger192stream() { Internal::tiger_init(State); }
+        void Update(const void *Input, size_t Size)
+        {
+            Internal::tiger_write_large((const uint8_t *)Input, Size, State);
+        }
+        void Update(std::string_view Input)
+        {
+            Update(Input.data(), Input.size());
+        }
+
+        // Same formats as the one-shot versions, the stream needs to be reset before reuse.
+        void Finalize(uint8_t Output[24])
+        {
+            std::memcpy(Output, Internal::tiger_final(State), 24);
+        }
+        std::string Finalize()
+        {
+            return Internal::tiger_digest(State);
+        }
+        void Reset()
+        {
+            Internal::tiger_init(State);
+        }
+    };
+
+    // Multiple independent inputs hashed in interleaved lanes, same output as calling Tiger192 on each.
+    template <size_t Lanes> requires (Lanes >= 2 && Lanes <= 4)
+    void Tiger192(const void *const (&Inputs)[Lanes], const size_t (&Sizes)[Lanes], uint8_t (&Outputs)[Lanes][24])
+    {
+        Internal::tiger_state States[Lanes];
+        Internal::tiger_state *Pointers[Lanes];
+        const uint8_t *Offsets[Lanes];
+
+        for (size_t l = 0; l < Lanes; ++l)
+        {
+            Internal::tiger_init(States[l]);
+            Offsets[l] = (const uint8_t *)Inputs[l];
+            Pointers[l] = &States[l];
+        }
+
+        // Lanes run together for the common length, the rest is done one by one.
+        const auto Common = *std::min_element(std::begin(Sizes), std::end(Sizes));
+        Internal::tiger_write_lanes<Lanes>(Offsets, Common, Pointers);
+
+        for (size_t l = 0; l < Lanes; ++l)
+        {
+            Internal::tiger_write_large(Offsets[l] + Common, Sizes[l] - Common, States[l]);
+            std::memcpy(Outputs[l], Internal::tiger_final(States[l]), 24);
+        }
+    }
+
+    // Tiger Tree Hash (THEX), compatible with other TTH implementations.
+    // Subtrees of 1 MiB are hashed on separate threads and combined, which yields the same root.
+    inline std::string Tiger192tree(const void *Input, const size_t Size, size_t Threadcount = std::thread::hardware_concurrency())
+    {
+        constexpr size_t Chunksize = 1024 * 1024;
+        const auto Chunkcount = std::max(size_t(1), (Size + Chunksize - 1) / Chunksize);
+        std::vector<std::string> Nodes(Chunkcount);
+
+        std::atomic<size_t> Next{};
+
+        const auto Worker = [&]()
+        {
+            for (auto Chunk = Next++; Chunk < Chunkcount; Chunk = Next++)
+            {
+                const auto Offset = Chunk * Chunksize;
+                Internal::tigertree_subtree((const uint8_t *)Input + Offset, std::min(Chunksize, Size - std::min(Size, Offset)), Nodes[Chunk]);
+            }
+        };
+
+        // The calling thread does its share.
+        Threadcount = std::clamp(Threadcount, size_t(1), Chunkcount);
+        std::vector<std::thread> Threads;
+        Threads.reserve(Threadcount - 1);
+
+        for (size_t i = 1; i < Threadcount; ++i) Threads.emplace_back(Worker);
+        Worker();
+        for (auto &Thread : Threads) Thread.join();
 
-        Resultstring.append((const char *)Resultbuffer, 24);
-        return Resultstring;
+        // The chunk-roots are the tree's nodes at the 1 MiB level.
+        return Internal::tigertree_combine(Nodes);
     }
 }
 #pragma warning(pop)
@@ -2,11 +2,17 @@
     Initial author: Convery (tcn@ayria.se)
     Started: 2019-03-14
     License: MIT
+
+    The SIMD kernels are based on the work by Wojciech Muła and Daniel Lemire.
+    They process full blocks and leave the tail / padding to the scalar path.
 */
 
 #pragma once
 #include <cstdint>
+#include <span>
+#include <string>
 #include <string_view>
+#include "../Internal/Cpufeatures.hpp"
 using Blob = std::basic_string<uint8_t>;
 using Blob_view = std::basic_string_view<uint8_t>;
 
@@ -22,7 +28,7 @@ namespace Base64
             'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r',
             's', 't', 'u', 'v', 'w', 'x', 'y', 'z', '0', '1', '2',
             '3', '4', '5', '6', '7', '8', '9', '+', '/' };
-        constexpr char Reversetable[128] =
+        constexpr uint8_t Reversetable[256] =
         {
             64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
             64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
@@ -31,109 +37,521 @@ namespace Base64
             64,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
             15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 64, 64, 64, 64, 64,
             64, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
-            41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 64, 64, 64, 64, 64
+            41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 64, 64, 64, 64, 64,
+            64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+            64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+            64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+            64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+            64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+            64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+            64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+            64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64
         };
-    }
 
-    [[nodiscard]] inline std::string Encode(std::string_view Input)
-    {
-        std::string Result((((Input.size() + 2) / 3) * 4), '=');
-        size_t Outputposition{};
-        uint32_t Accumulator{};
-        uint32_t Bits{};
+        #pragma region Scalar
+        // Encodes everything, including the padded tail, returns the number of chars written.
+        inline size_t Encode_scalar(const uint8_t *Input, size_t Length, uint8_t *Output)
+        {
+            const auto Start = Output;
 
-        for (const auto &Item : Input)
+            for (; Length >= 3; Length -= 3, Input += 3)
+            {
+                const uint32_t Triplet = (Input[0] << 16) | (Input[1] << 8) | Input[2];
+                *Output++ = Table[(Triplet >> 18) & 0x3F];
+                *Output++ = Table[(Triplet >> 12) & 0x3F];
+                *Output++ = Table[(Triplet >> 6) & 0x3F];
+                *Output++ = Table[Triplet & 0x3F];
+            }
+
+            if (Length)
+            {
+                const uint32_t Triplet = (Input[0] << 16) | (Length == 2 ? (Input[1] << 8) : 0);
+                *Output++ = Table[(Triplet >> 18) & 0x3F];
+                *Output++ = Table[(Triplet >> 12) & 0x3F];
+                *Output++ = Length == 2 ? Table[(Triplet >> 6) & 0x3F] : '=';
+                *Output++ = '=';
+            }
+
+            return Output - Start;
+        }
+
+        // Expects the padding to be stripped, returns false on invalid characters.
+        inline bool Decode_scalar(const uint8_t *Input, size_t Length, uint8_t *Output, size_t &Written)
         {
-            Accumulator = (Accumulator << 8) | (Item & 0xFF);
-            Bits += 8;
-            while (Bits >= 6)
+            const auto Start = Output;
+            Written = 0;
+
+            for (; Length >= 4; Length -= 4, Input += 4)
             {
-                Bits -= 6;
-                Result[Outputposition++] = Internal::Table[(Accumulator >> Bits) & 0x3F];
+                const uint32_t A = Reversetable[Input[0]], B = Reversetable[Input[1]];
+                const uint32_t C = Reversetable[Input[2]], D = Reversetable[Input[3]];
+                if ((A | B | C | D) & 0x40) [[unlikely]] return false;
+
+                const uint32_t Triplet = (A << 18) | (B << 12) | (C << 6) | D;
+                *Output++ = uint8_t(Triplet >> 16);
+                *Output++ = uint8_t(Triplet >> 8);
+                *Output++ = uint8_t(Triplet);
+                Written = Output - Start;
+            }
+
+            // A single char can not represent a full byte.
+            if (Length == 1) return false;
+            if (Length >= 2)
+            {
+                const uint32_t A = Reversetable[Input[0]], B = Reversetable[Input[1]];
+                const uint32_t C = Length == 3 ? Reversetable[Input[2]] : 0;
+                if ((A | B | C) & 0x40) [[unlikely]] return false;
+
+                const uint32_t Triplet = (A << 18) | (B << 12) | (C << 6);
+                *Output++ = uint8_t(Triplet >> 16);
+                if (Length == 3) *Output++ = uint8_t(Triplet >> 8);
+                Written = Output - Start;
             }
+
+            return true;
         }
+        #pragma endregion
 
-        if (Bits)
+        #pragma region SSSE3
+        // Convert 6-bit indices to ASCII.
+        TARGET_ATTR("ssse3") inline __m128i Lookup_SSSE3(__m128i Indices)
         {
-            Accumulator <<= (6 - Bits);
-            Result[Outputposition] = Internal::Table[Accumulator & 0x3F];
+            const auto Offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                               '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+
+            auto Result = _mm_subs_epu8(Indices, _mm_set1_epi8(51));
+            const auto Lessthan = _mm_cmpgt_epi8(_mm_set1_epi8(26), Indices);
+            Result = _mm_or_si128(Result, _mm_and_si128(Lessthan, _mm_set1_epi8(13)));
+            return _mm_add_epi8(_mm_shuffle_epi8(Offsets, Result), Indices);
         }
 
-        return Result;
-    }
-    [[nodiscard]] inline std::string Decode(std::string_view Input)
-    {
-        std::string Result(((Input.size() / 4) * 3), '\0');
-        size_t Outputposition{};
-        uint32_t Accumulator{};
-        uint32_t Bits{};
+        // Returns the number of bytes consumed, 12 bytes per block.
+        TARGET_ATTR("ssse3") inline size_t Encode_SSSE3(const uint8_t *Input, size_t Length, uint8_t *Output)
+        {
+            const auto Shuffle = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+            size_t Consumed{};
 
-        for (const auto &Item : Input)
+            // Loads are 16 bytes wide.
+            while (Length - Consumed >= 16)
+            {
+                const auto Block = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(Input + Consumed)), Shuffle);
+
+                // Split the 3 bytes into 4 indices.
+                const auto T0 = _mm_mulhi_epu16(_mm_and_si128(Block, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+                const auto T1 = _mm_mullo_epi16(_mm_and_si128(Block, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+
+                _mm_storeu_si128((__m128i *)Output, Lookup_SSSE3(_mm_or_si128(T0, T1)));
+                Output += 16; Consumed += 12;
+            }
+
+            return Consumed;
+        }
+
+        // Returns the number of chars consumed, 16 chars per block; stops before invalid blocks.
+        TARGET_ATTR("ssse3") inline size_t Decode_SSSE3(const uint8_t *Input, size_t Length, uint8_t *Output)
+        {
+            const auto Lutlo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                             0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+            const auto Luthi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                             0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+            const auto Lutroll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+            const auto Pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+            const auto Nibblemask = _mm_set1_epi8(0x0F);
+            size_t Consumed{};
+
+            // Stores are 16 bytes wide, so leave enough input that the output has room for them.
+            while (Length - Consumed >= 24)
+            {
+                auto Block = _mm_loadu_si128((const __m128i *)(Input + Consumed));
+                const auto Hinibbles = _mm_and_si128(_mm_srli_epi32(Block, 4), Nibblemask);
+                const auto Lonibbles = _mm_and_si128(Block, Nibblemask);
+
+                // Invalid characters (including padding) have overlapping bits in the LUTs.
+                const auto Lo = _mm_shuffle_epi8(Lutlo, Lonibbles);
+                const auto Hi = _mm_shuffle_epi8(Luthi, Hinibbles);
+                if (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(Lo, Hi), _mm_setzero_si128()))) [[unlikely]] break;
+
+                // '/' shares the high nibble with '+', so offset its index.
+                const auto Slash = _mm_cmpeq_epi8(Block, _mm_set1_epi8(0x2F));
+                Block = _mm_add_epi8(Block, _mm_shuffle_epi8(Lutroll, _mm_add_epi8(Slash, Hinibbles)));
+
+                // Merge the 6-bit values into 24-bit groups and compact them.
+                Block = _mm_maddubs_epi16(Block, _mm_set1_epi32(0x01400140));
+                Block = _mm_madd_epi16(Block, _mm_set1_epi32(0x00011000));
+                _mm_storeu_si128((__m128i *)Output, _mm_shuffle_epi8(Block, Pack));
+
+                Output += 12; Consumed += 16;
+            }
+
+            return Consumed;
+        }
+        #pragma endregion
+
+        #pragma region AVX2
+        TARGET_ATTR("avx2") inline __m256i Lookup_AVX2(__m256i Indices)
         {
-            if (Item == '=') continue;
+            const auto Offsets = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                                  '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+                                                  'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                                  '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+
+            auto Result = _mm256_subs_epu8(Indices, _mm256_set1_epi8(51));
+            const auto Lessthan = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), Indices);
+            Result = _mm256_or_si256(Result, _mm256_and_si256(Lessthan, _mm256_set1_epi8(13)));
+            return _mm256_add_epi8(_mm256_shuffle_epi8(Offsets, Result), Indices);
+        }
 
-            Accumulator = (Accumulator << 6) | Internal::Reversetable[static_cast<uint8_t>(Item)];
-            Bits += 6;
+        // Returns the number of bytes consumed, 24 bytes per block.
+        TARGET_ATTR("avx2") inline size_t Encode_AVX2(const uint8_t *Input, size_t Length, uint8_t *Output)
+        {
+            const auto Shuffle = _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+                                                 10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+            size_t Consumed{};
 
-            if (Bits >= 8)
+            // Each lane loads 16 bytes, the upper one starting at offset 12.
+            while (Length - Consumed >= 28)
             {
-                Bits -= 8;
-                Result[Outputposition++] = static_cast<char>((Accumulator >> Bits) & 0xFF);
+                const auto Low = _mm_loadu_si128((const __m128i *)(Input + Consumed));
+                const auto High = _mm_loadu_si128((const __m128i *)(Input + Consumed + 12));
+                const auto Block = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(Low), High, 1), Shuffle);
+
+                const auto T0 = _mm256_mulhi_epu16(_mm256_and_si256(Block, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040));
+                const auto T1 = _mm256_mullo_epi16(_mm256_and_si256(Block, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010));
+
+                _mm256_storeu_si256((__m256i *)Output, Lookup_AVX2(_mm256_or_si256(T0, T1)));
+                Output += 32; Consumed += 24;
             }
+
+            return Consumed;
         }
 
+        // Returns the number of chars consumed, 32 chars per block; stops before invalid blocks.
+        TARGET_ATTR("avx2") inline size_t Decode_AVX2(const uint8_t *Input, size_t Length, uint8_t *Output)
+        {
+            const auto Lutlo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+                                                0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+            const auto Luthi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                                0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+            const auto Lutroll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+                                                  0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+            const auto Pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                               2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+            const auto Nibblemask = _mm256_set1_epi8(0x0F);
+            size_t Consumed{};
+
+            // Stores are 32 bytes wide, so leave enough input that the output has room for them.
+            while (Length - Consumed >= 48)
+            {
+                auto Block = _mm256_loadu_si256((const __m256i *)(Input + Consumed));
+                const auto Hinibbles = _mm256_and_si256(_mm256_srli_epi32(Block, 4), Nibblemask);
+                const auto Lonibbles = _mm256_and_si256(Block, Nibblemask);
+
+                const auto Lo = _mm256_shuffle_epi8(Lutlo, Lonibbles);
+                const auto Hi = _mm256_shuffle_epi8(Luthi, Hinibbles);
+                if (_mm256_movemask_epi8(_mm256_cmpgt_epi8(_mm256_and_si256(Lo, Hi), _mm256_setzero_si256()))) [[unlikely]] break;
+
+                const auto Slash = _mm256_cmpeq_epi8(Block, _mm256_set1_epi8(0x2F));
+                Block = _mm256_add_epi8(Block, _mm256_shuffle_epi8(Lutroll, _mm256_add_epi8(Slash, Hinibbles)));
+
+                Block = _mm256_maddubs_epi16(Block, _mm256_set1_epi32(0x01400140));
+                Block = _mm256_madd_epi16(Block, _mm256_set1_epi32(0x00011000));
+                Block = _mm256_shuffle_epi8(Block, Pack);
+
+                // Move the 12 bytes of each lane next to each other.
+                Block = _mm256_permutevar8x32_epi32(Block, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+                _mm256_storeu_si256((__m256i *)Output, Block);
+
+                Output += 24; Consumed += 32;
+            }
+
+            return Consumed;
+        }
+        #pragma endregion
+
+        // Dispatch to the best kernel available, returns the number of chars written.
+        inline size_t Encode(const uint8_t *Input, size_t Length, uint8_t *Output)
+        {
+            size_t Consumed{};
+
+            if (Cpufeatures::hasAVX2()) Consumed = Encode_AVX2(Input, Length, Output);
+            else if (Cpufeatures::hasSSSE3()) Consumed = Encode_SSSE3(Input, Length, Output);
+
+            const size_t Written = (Consumed / 3) * 4;
+            return Written + Encode_scalar(Input + Consumed, Length - Consumed, Output + Written);
+        }
+
+        // Returns false if the input contains invalid characters, Written is set either way.
+        inline bool Decode(const uint8_t *Input, size_t Length, uint8_t *Output, size_t &Written)
+        {
+            // Padding is only valid at the end.
+            if (Length && Input[Length - 1] == '=') --Length;
+            if (Length && Input[Length - 1] == '=') --Length;
+
+            size_t Consumed{};
+            if (Cpufeatures::hasAVX2()) Consumed += Decode_AVX2(Input, Length, Output);
+            if (Cpufeatures::hasSSSE3()) Consumed += Decode_SSSE3(Input + Consumed, Length - Consumed, Output + (Consumed / 4) * 3);
+
+            size_t Tail{};
+            const auto Valid = Decode_scalar(Input + Consumed, Length - Consumed, Output + (Consumed / 4) * 3, Tail);
+            Written = (Consumed / 4) * 3 + Tail;
+            return Valid;
+        }
+    }
+
+    [[nodiscard]] constexpr size_t Encodesize(size_t Inputlength)
+    {
+        return ((Inputlength + 2) / 3) * 4;
+    }
+
+    [[nodiscard]] inline std::string Encode(std::string_view Input)
+    {
+        std::string Result(Encodesize(Input.size()), '=');
+        Internal::Encode((const uint8_t *)Input.data(), Input.size(), (uint8_t *)Result.data());
+        return Result;
+    }
+    [[nodiscard]] inline std::string Decode(std::string_view Input)
+    {
+        std::string Result(((Input.size() + 3) / 4) * 3, '\0');
+        size_t Written{};
+
+        // Lenient, stops at the first invalid block.
+        (void)Internal::Decode((const uint8_t *)Input.data(), Input.size(), (uint8_t *)Result.data(), Written);
+        Result.resize(Written);
         return Result;
     }
 
     [[nodiscard]] inline Blob Encode(Blob_view Input)
     {
-        Blob Result((((Input.size() + 2) / 3) * 4), '=');
-        size_t Outputposition{};
-        uint32_t Accumulator{};
-        uint32_t Bits{};
+        Blob Result(Encodesize(Input.size()), '=');
+        Internal::Encode(Input.data(), Input.size(), Result.data());
+        return Result;
+    }
+    [[nodiscard]] inline Blob Decode(Blob_view Input)
+    {
+        Blob Result(((Input.size() + 3) / 4) * 3, '\0');
+        size_t Written{};
 
-        for (const auto &Item : Input)
+        // Lenient, stops at the first invalid block.
+        (void)Internal::Decode(Input.data(), Input.size(), Result.data(), Written);
+        Result.resize(Written);
+        return Result;
+    }
+
+    // Validates while decoding, equivalent to isValid() followed by Decode() but in a single pass.
+    [[nodiscard]] inline bool Trydecode(std::string_view Input, std::string &Output)
+    {
+        if (Input.empty() || Input.size() % 4 != 0) return false;
+
+        Output.resize((Input.size() / 4) * 3);
+        size_t Written{};
+
+        const auto Valid = Internal::Decode((const uint8_t *)Input.data(), Input.size(), (uint8_t *)Output.data(), Written);
+        Output.resize(Written);
+        return Valid;
+    }
+    [[nodiscard]] inline bool Trydecode(Blob_view Input, Blob &Output)
+    {
+        if (Input.empty() || Input.size() % 4 != 0) return false;
+
+        Output.resize((Input.size() / 4) * 3);
+        size_t Written{};
+
+        const auto Valid = Internal::Decode(Input.data(), Input.size(), Output.data(), Written);
+        Output.resize(Written);
+        return Valid;
+    }
+
+    // Exact output sizes, for use with the *Into functions.
+    [[nodiscard]] constexpr size_t Decodesize(const char *Input, size_t Length)
+    {
+        if (Length && Input[Length - 1] == '=') --Length;
+        if (Length && Input[Length - 1] == '=') --Length;
+
+        constexpr size_t Tail[4] = { 0, 0, 1, 2 };
+        return (Length / 4) * 3 + Tail[Length % 4];
+    }
+    [[nodiscard]] constexpr size_t Decodesize(std::string_view Input)
+    {
+        return Decodesize(Input.data(), Input.size());
+    }
+    [[nodiscard]] inline size_t Decodesize(Blob_view Input)
+    {
+        return Decodesize((const char *)Input.data(), Input.size());
+    }
+
+    // Write into caller-provided storage, returns the number of bytes written or 0 if the buffer is too small.
+    inline size_t EncodeInto(std::string_view Input, std::span<char> Output)
+    {
+        if (Output.size() < Encodesize(Input.size())) return 0;
+        return Internal::Encode((const uint8_t *)Input.data(), Input.size(), (uint8_t *)Output.data());
+    }
+    inline size_t EncodeInto(Blob_view Input, std::span<uint8_t> Output)
+    {
+        if (Output.size() < Encodesize(Input.size())) return 0;
+        return Internal::Encode(Input.data(), Input.size(), Output.data());
+    }
+
+    // Returns the number of bytes written, 0 if the buffer is too small or the input is invalid.
+    inline size_t DecodeInto(std::string_view Input, std::span<char> Output)
+    {
+        if (Output.size() < Decodesize(Input)) return 0;
+
+        size_t Written{};
+        if (!Internal::Decode((const uint8_t *)Input.data(), Input.size(), (uint8_t *)Output.data(), Written)) return 0;
+        return Written;
+    }
+    inline size_t DecodeInto(Blob_view Input, std::span<uint8_t> Output)
+    {
+        if (Output.size() < Decodesize(Input)) return 0;
+
+        size_t Written{};
+        if (!Internal::Decode(Input.data(), Input.size(), Output.data(), Written)) return 0;
+        return Written;
+    }
+
+    // Incremental encoding of chunked input, partial blocks are carried between calls.
+    struct Streamencoder
+    {
+        uint8_t Pending[3]{};
+        size_t Pendingcount{};
+
+        // Upper bound on the output of the next Update, Finalize needs at most 4 bytes.
+        [[nodiscard]] constexpr size_t Updatesize(size_t Inputlength) const
+        {
+            return ((Pendingcount + Inputlength) / 3) * 4;
+        }
+
+        // Returns the number of bytes written, 0 if the buffer is too small (the input is not consumed).
+        size_t Update(const void *Input, size_t Length, uint8_t *Output, size_t Outputsize)
         {
-            Accumulator = (Accumulator << 8) | (Item & 0xFF);
-            Bits += 8;
-            while (Bits >= 6)
+            if (Outputsize < Updatesize(Length)) return 0;
+
+            auto Data = (const uint8_t *)Input;
+            size_t Written{};
+
+            // Complete the previous block.
+            if (Pendingcount)
             {
-                Bits -= 6;
-                Result[Outputposition++] = Internal::Table[(Accumulator >> Bits) & 0x3F];
+                while (Pendingcount < 3 && Length) { Pending[Pendingcount++] = *Data++; --Length; }
+                if (Pendingcount < 3) return 0;
+
+                Written += Internal::Encode(Pending, 3, Output);
+                Pendingcount = 0;
             }
+
+            // Bulk encode whole blocks, keep the remainder for the next call.
+            const auto Blocklength = Length - (Length % 3);
+            Written += Internal::Encode(Data, Blocklength, Output + Written);
+
+            for (size_t i = Blocklength; i < Length; ++i) Pending[Pendingcount++] = Data[i];
+            return Written;
+        }
+        size_t Update(std::string_view Input, std::span<char> Output)
+        {
+            return Update(Input.data(), Input.size(), (uint8_t *)Output.data(), Output.size());
+        }
+        size_t Update(Blob_view Input, std::span<uint8_t> Output)
+        {
+            return Update(Input.data(), Input.size(), Output.data(), Output.size());
         }
 
-        if (Bits)
+        // Flush and pad the last block, the encoder can be reused afterwards.
+        size_t Finalize(uint8_t *Output, size_t Outputsize)
         {
-            Accumulator <<= (6 - Bits);
-            Result[Outputposition] = Internal::Table[Accumulator & 0x3F];
+            if (Outputsize < Encodesize(Pendingcount)) return 0;
+
+            const auto Written = Internal::Encode_scalar(Pending, Pendingcount, Output);
+            Pendingcount = 0;
+            return Written;
         }
+        size_t Finalize(std::span<char> Output) { return Finalize((uint8_t *)Output.data(), Output.size()); }
+        size_t Finalize(std::span<uint8_t> Output) { return Finalize(Output.data(), Output.size()); }
+    };
 
-        return Result;
-    }
-    [[nodiscard]] inline Blob Decode(Blob_view Input)
+    // Incremental decoding of chunked input, padding is only accepted in the last block.
+    struct Streamdecoder
     {
-        Blob Result(((Input.size() / 4) * 3), '\0');
-        size_t Outputposition{};
-        uint32_t Accumulator{};
-        uint32_t Bits{};
+        uint8_t Pending[4]{};
+        size_t Pendingcount{};
+        bool hasFailed{}, hasPadding{};
 
-        for (const auto &Item : Input)
+        // Upper bound on the output of the next Update, Finalize needs at most 2 bytes.
+        [[nodiscard]] constexpr size_t Updatesize(size_t Inputlength) const
+        {
+            return ((Pendingcount + Inputlength) / 4) * 3;
+        }
+
+        // Returns the number of bytes written, 0 on errors or if the buffer is too small (the input is not consumed).
+        size_t Update(const void *Input, size_t Length, uint8_t *Output, size_t Outputsize)
         {
-            if (Item == '=') continue;
+            if (hasFailed || Outputsize < Updatesize(Length)) return 0;
+            if (!Length) return 0;
+
+            // Data after the padding.
+            if (hasPadding) { hasFailed = true; return 0; }
+
+            auto Data = (const uint8_t *)Input;
+            size_t Written{};
 
-            Accumulator = (Accumulator << 6) | Internal::Reversetable[static_cast<uint8_t>(Item)];
-            Bits += 6;
+            const auto Decodeblocks = [&](const uint8_t *Blocks, size_t Blocklength)
+            {
+                size_t Count{};
+                hasPadding = Blocks[Blocklength - 1] == '=';
+                hasFailed |= !Internal::Decode(Blocks, Blocklength, Output + Written, Count);
+                Written += Count;
+            };
 
-            if (Bits >= 8)
+            // Complete the previous block.
+            if (Pendingcount)
             {
-                Bits -= 8;
-                Result[Outputposition++] = static_cast<char>((Accumulator >> Bits) & 0xFF);
+                while (Pendingcount < 4 && Length) { Pending[Pendingcount++] = *Data++; --Length; }
+                if (Pendingcount < 4) return 0;
+
+                Decodeblocks(Pending, 4);
+                Pendingcount = 0;
+
+                if (hasFailed) return 0;
+                if (hasPadding && Length) { hasFailed = true; return 0; }
             }
+
+            // Bulk decode whole blocks, keep the remainder for the next call.
+            const auto Blocklength = Length - (Length % 4);
+            if (Blocklength)
+            {
+                Decodeblocks(Data, Blocklength);
+                if (hasFailed) return 0;
+                if (hasPadding && Length != Blocklength) { hasFailed = true; return 0; }
+            }
+
+            for (size_t i = Blocklength; i < Length; ++i) Pending[Pendingcount++] = Data[i];
+            return Written;
+        }
+        size_t Update(std::string_view Input, std::span<char> Output)
+        {
+            return Update(Input.data(), Input.size(), (uint8_t *)Output.data(), Output.size());
+        }
+        size_t Update(Blob_view Input, std::span<uint8_t> Output)
+        {
+            return Update(Input.data(), Input.size(), Output.data(), Output.size());
         }
 
-        return Result;
-    }
+        // Decode unpadded trailing chars, returns false if the stream as a whole was invalid.
+        bool Finalize(uint8_t *Output, size_t Outputsize, size_t &Written)
+        {
+            Written = 0;
+            if (Pendingcount && !hasFailed)
+            {
+                if (Outputsize < 2) return false;
+                hasFailed = !Internal::Decode(Pending, Pendingcount, Output, Written);
+            }
+
+            const auto Result = !hasFailed;
+            *this = {};
+            return Result;
+        }
+        bool Finalize(std::span<char> Output, size_t &Written) { return Finalize((uint8_t *)Output.data(), Output.size(), Written); }
+        bool Finalize(std::span<uint8_t> Output, size_t &Written) { return Finalize(Output.data(), Output.size(), Written); }
+    };
 
     [[nodiscard]] constexpr bool isValid(Blob_view Input)
     {
@@ -13,108 +13,155 @@
 struct Bitbuffer
 {
     std::unique_ptr<uint8_t[]> Internalbuffer;
-    size_t Internalsize{}, Internaliterator{};
+    size_t Internalsize{}, Internalcapacity{}, Internaliterator{};
     bool Quakecompatibible{ false };
 
+    // The allocation has a word of zeroed slack so that 64-bit loads and stores never leave it.
+    static constexpr size_t Slack = sizeof(uint64_t);
+
     // Construct the buffer from different containers.
     template <typename Type> Bitbuffer(const std::basic_string<Type> &Data) : Bitbuffer(Data.data(), Data.size()) {}
     template <typename Type> Bitbuffer(const std::vector<Type> &Data) : Bitbuffer(Data.data(), Data.size()) {}
     template <typename Iterator> Bitbuffer(Iterator Begin, Iterator End)
     {
-        Internalbuffer = std::make_unique<uint8_t[]>(std::distance(Begin, End) + 1);
+        Internalbuffer = std::make_unique<uint8_t[]>(std::distance(Begin, End) + Slack);
         std::copy(Begin, End, Internalbuffer.get());
-        Internalsize = std::distance(Begin, End);
+        Internalsize = Internalcapacity = std::distance(Begin, End);
     }
     Bitbuffer(const void *Data, size_t Size)
     {
-        Internalbuffer = std::make_unique<uint8_t[]>(Size + 1);
+        Internalbuffer = std::make_unique<uint8_t[]>(Size + Slack);
         std::memcpy(Internalbuffer.get(), Data, Size);
-        Internalsize = Size;
+        Internalsize = Internalcapacity = Size;
     }
     Bitbuffer(const Bitbuffer &Right)
     {
-        Internalsize = Right.Internalsize;
+        Internalsize = Internalcapacity = Right.Internalsize;
         Internaliterator = Right.Internaliterator;
-        Internalbuffer = std::make_unique<uint8_t[]>(Internalsize);
+        Internalbuffer = std::make_unique<uint8_t[]>(Internalsize + Slack);
         std::memcpy(Internalbuffer.get(), Right.Internalbuffer.get(), Internalsize);
+        Quakecompatibible = Right.Quakecompatibible;
     }
     Bitbuffer(Bitbuffer &&Right) noexcept
     {
         Internaliterator = Right.Internaliterator;
         Internalbuffer.swap(Right.Internalbuffer);
+        Internalcapacity = Right.Internalcapacity;
         Internalsize = Right.Internalsize;
+        Quakecompatibible = Right.Quakecompatibible;
     }
     Bitbuffer() = default;
 
-    // Basic IO.
+    // Grow geometrically to amortize the copies when serializing field by field.
+    void Reserve(size_t Bytecount)
+    {
+        if (Bytecount <= Internalcapacity) [[likely]] return;
+
+        const auto Newcapacity = std::max({ Bytecount, Internalcapacity * 2, size_t(64) });
+        auto Newbuffer = std::make_unique<uint8_t[]>(Newcapacity + Slack);
+        if (Internalbuffer) std::memcpy(Newbuffer.get(), Internalbuffer.get(), Internalsize);
+
+        Internalbuffer.swap(Newbuffer);
+        Internalcapacity = Newcapacity;
+    }
+
+    // Basic IO, bits are stored LSB first.
     void Rawwrite(size_t Writecount, const void *Buffer = nullptr)
     {
         // Expand the buffer if needed.
-        if (Internaliterator + Writecount > Internalsize * 8)
-        {
-            auto Newbuffer = std::make_unique<uint8_t[]>(Internalsize + Writecount / 8 + 1);
-            std::memmove(Newbuffer.get(), Internalbuffer.get(), Internalsize);
-            Internalsize += Writecount / 8 + 1;
-            Internalbuffer.swap(Newbuffer);
-        }
+        Reserve((Internaliterator + Writecount + 7) / 8);
 
-        const auto Input = (uint8_t *)Buffer;
-        size_t Bitstowrite = Writecount;
-
-        while (Bitstowrite)
+        // Can be null when padding/aligning.
+        if (const auto Input = (const uint8_t *)Buffer)
         {
-            const size_t Readposition = (Writecount - Bitstowrite) / 8;
-            const uint8_t Currentbit = (Writecount - Bitstowrite) & 7;
-            const uint8_t Writeposition = Internaliterator & 7;
-            const uint8_t Currentwrite = uint8_t(std::min(Bitstowrite, size_t(8 - Writeposition)));
+            size_t Written{};
 
-            // Can be null when padding/aligning.
-            if (Input)
+            // Byte-aligned bulk data is just a copy.
+            if ((Internaliterator & 7) == 0 && Writecount >= 8)
             {
-                uint8_t Inputbyte = Input[Readposition];
-                const uint8_t Nextbyte = (Writecount - 1) / 8 > Readposition ? Input[Readposition + 1] : 0;
-                const uint8_t Mask = (0xFF >> (8 - Writeposition)) | (0xFF << (Writeposition + Currentwrite));
-
-                Inputbyte = (Nextbyte << (8 - Currentbit)) | Inputbyte >> Currentbit;
-                const uint8_t Resultbyte = (~Mask & (Inputbyte << Writeposition)) | (Mask & Internalbuffer[Internaliterator / 8]);
-                Internalbuffer[Internaliterator / 8] = Resultbyte;
+                const auto Bytecount = Writecount / 8;
+                std::memcpy(Internalbuffer.get() + Internaliterator / 8, Input, Bytecount);
+                Written = Bytecount * 8;
             }
 
-            Internaliterator += Currentwrite;
-            Bitstowrite -= Currentwrite;
+            // 56 bits per step, so the shifted value still fits in the accumulator.
+            while (Written < Writecount)
+            {
+                const auto Count = std::min(Writecount - Written, size_t(56));
+                const auto Inputbytes = (Count + 7) / 8;
+                const auto Mask = (uint64_t(1) << Count) - 1;
+                const auto Offset = Internaliterator + Written;
+                const auto Shift = Offset & 7;
+
+                // The callers buffer has no slack, so only read what we need.
+                uint64_t Bits{};
+                std::memcpy(&Bits, Input + Written / 8, Inputbytes);
+
+                uint64_t Word;
+                const auto Output = Internalbuffer.get() + Offset / 8;
+                std::memcpy(&Word, Output, sizeof(Word));
+                Word = (Word & ~(Mask << Shift)) | ((Bits & Mask) << Shift);
+                std::memcpy(Output, &Word, sizeof(Word));
+
+                Written += Count;
+            }
         }
+
+        Internaliterator += Writecount;
+        Internalsize = std::max(Internalsize, (Internaliterator + 7) / 8);
     }
     bool Rawread(size_t Readcount, void *Buffer = nullptr)
     {
-        auto Output = (uint8_t *)Buffer;
         if (Internaliterator + Readcount > Internalsize * 8) return false;
 
-        while (Readcount)
+        // Can be null for discarding data.
+        if (const auto Output = (uint8_t *)Buffer)
         {
-            const uint8_t Thisread = uint8_t(std::min(Readcount, size_t(8)));
-            const uint8_t Thisbyte = Internalbuffer[Internaliterator / 8];
-            const uint8_t Remaining = Internaliterator & 7;
+            size_t Read{};
 
-            // Can be null for discarding data.
-            if (Buffer)
+            // Byte-aligned bulk data is just a copy.
+            if ((Internaliterator & 7) == 0 && Readcount >= 8)
             {
-                if (Thisread + Remaining <= 8)
-                {
-                    *Output = (0xFF >> (8 - Thisread)) & (Thisbyte >> Remaining);
-                }
-                else
-                {
-                    *Output = ((0xFF >> (8 - Thisread)) & (Internalbuffer[Internaliterator / 8 + 1] << (8 - Remaining))) | (Thisbyte >> Remaining);
-                }
-
-                Output++;
+                const auto Bytecount = Readcount / 8;
+                std::memcpy(Output, Internalbuffer.get() + Internaliterator / 8, Bytecount);
+                Read = Bytecount * 8;
+            }
+
+            while (Read < Readcount)
+            {
+                const auto Count = std::min(Readcount - Read, size_t(56));
+                const auto Offset = Internaliterator + Read;
+
+                uint64_t Word;
+                std::memcpy(&Word, Internalbuffer.get() + Offset / 8, sizeof(Word));
+                Word = (Word >> (Offset & 7)) & ((uint64_t(1) << Count) - 1);
+
+                // Unused bits in the last byte are cleared.
+                std::memcpy(Output + Read / 8, &Word, (Count + 7) / 8);
+                Read += Count;
             }
-            Readcount -= Thisread;
-            Internaliterator += Thisread;
         }
 
+        Internaliterator += Readcount;
         return true;
     }
+    void Varintwrite(uint64_t Value)
+    {
+        uint8_t Encoded[Varint::Maxsize];
+        Rawwrite(Varint::Encode(Value, Encoded) * 8, Encoded);
+    }
+    bool Varintread(uint64_t &Value)
+    {
+        // Peek at the next few bytes, the iterator may not be byte-aligned.
+        uint8_t Peeked[Varint::Maxsize]{};
+        const auto Available = std::min(Varint::Maxsize, (Internalsize * 8 - Internaliterator) / 8);
+        const auto Offset = Internaliterator;
+        Rawread(Available * 8, Peeked);
+
+        const auto Consumed = Varint::Decode(Peeked, Available, Value);
+        Internaliterator = Offset + Consumed * 8;
+        return Consumed != 0;
+    }
 
     // Typed IO.
     template <typename Type> void Write(const Type Value, bool Typechecked = true)
@@ -245,6 +292,64 @@ struct Bitbuffer
         return Result;
     }
 
+    // Compact integers, the type-prefix is the same as for the fixed-width encoding.
+    template <typename Type> void Writevarint(const Type Value, bool Typechecked = true)
+    {
+        constexpr auto TypeID = Internal::toID<Type>();
+        if (Typechecked) Rawwrite(5, &TypeID);
+
+        Varintwrite(Varint::fromInteger(Value));
+    }
+    template <typename Type> void Writedelta(const Type Value, const Type Previous, bool Typechecked = true)
+    {
+        constexpr auto TypeID = Internal::toID<Type>();
+        if (Typechecked) Rawwrite(5, &TypeID);
+
+        Varintwrite(Varint::fromDelta(Value, Previous));
+    }
+    template <typename Type> bool Readvarint(Type &Buffer, bool Typechecked = true)
+    {
+        constexpr auto TypeID = Internal::toID<Type>();
+        uint8_t Storedtype;
+
+        // Verify the data-type.
+        if (Typechecked)
+        {
+            if (!Rawread(5, &Storedtype))
+                return false;
+
+            if (Storedtype != TypeID)
+            {
+                Internaliterator -= 5;
+                return false;
+            }
+        }
+
+        uint64_t Value{};
+        return Varintread(Value) && Varint::toInteger(Value, Buffer);
+    }
+    template <typename Type> bool Readdelta(Type &Buffer, const Type Previous, bool Typechecked = true)
+    {
+        constexpr auto TypeID = Internal::toID<Type>();
+        uint8_t Storedtype;
+
+        // Verify the data-type.
+        if (Typechecked)
+        {
+            if (!Rawread(5, &Storedtype))
+                return false;
+
+            if (Storedtype != TypeID)
+            {
+                Internaliterator -= 5;
+                return false;
+            }
+        }
+
+        uint64_t Value{};
+        return Varintread(Value) && Varint::toDelta(Value, Previous, Buffer);
+    }
+
     // Utility functionality.
     [[nodiscard]] Blob asBlob() const
     {
@@ -281,7 +386,9 @@ struct Bitbuffer
         {
             Internaliterator = std::exchange(Right.Internaliterator, NULL);
             Internalbuffer = std::exchange(Right.Internalbuffer, nullptr);
+            Internalcapacity = std::exchange(Right.Internalcapacity, NULL);
             Internalsize = std::exchange(Right.Internalsize, NULL);
+            Quakecompatibible = Right.Quakecompatibible;
         }
 
         return *this;
@@ -290,11 +397,19 @@ struct Bitbuffer
     {
         if (this != &Right)
         {
-            if (Internalsize != Right.Internalsize) Internalbuffer = std::make_unique<uint8_t[]>(Right.Internalsize);
-            std::memcpy(Internalbuffer.get(), Right.Internalbuffer.get(), Right.Internalsize);
+            // Reuse our allocation if it's large enough, the slack needs to stay zeroed.
+            if (Internalcapacity < Right.Internalsize)
+            {
+                Internalbuffer = std::make_unique<uint8_t[]>(Right.Internalsize + Slack);
+                Internalcapacity = Right.Internalsize;
+            }
+            else if (Internalbuffer) std::memset(Internalbuffer.get(), 0, Internalcapacity + Slack);
+
+            if (Right.Internalsize) std::memcpy(Internalbuffer.get(), Right.Internalbuffer.get(), Right.Internalsize);
 
             Internaliterator = Right.Internaliterator;
             Internalsize = Right.Internalsize;
+            Quakecompatibible = Right.Quakecompatibible;
         }
 
         return *this;
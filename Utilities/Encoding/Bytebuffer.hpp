@@ -10,6 +10,7 @@
 #pragma once
 #pragma warning(push)
 #include <Stdinclude.hpp>
+#include "Varint.hpp"
 #pragma warning(disable: 4702)
 using Blob = std::basic_string<uint8_t>;
 using Blob_view = std::basic_string_view<uint8_t>;
@@ -61,6 +62,9 @@ namespace Internal
         if constexpr (std::is_same<Type, std::basic_string<uint8_t>>::value)    return BB_BLOB;
         if constexpr (std::is_same<Type, std::basic_string<char>>::value)       return BB_ASCIISTRING;
         if constexpr (std::is_same<Type, std::basic_string<wchar_t>>::value)    return BB_UNICODESTRING;
+        if constexpr (std::is_same<Type, std::basic_string_view<uint8_t>>::value)   return BB_BLOB;
+        if constexpr (std::is_same<Type, std::basic_string_view<char>>::value)      return BB_ASCIISTRING;
+        if constexpr (std::is_same<Type, std::basic_string_view<wchar_t>>::value)   return BB_UNICODESTRING;
 
         // POD.
         if constexpr (std::is_same<typename std::decay<Type>::type, bool>::value)        return BB_BOOL;
@@ -78,73 +82,93 @@ namespace Internal
 
         return BB_NONE;
     }
+
+    // Pointers and views refer to the writer's memory, so they must never be copied to or from the wire as is.
+    template <typename Type> constexpr bool isReference = std::is_pointer_v<Type> || std::is_member_pointer_v<Type> || isDerived<Type, std::basic_string_view>::value;
+
+    // Elements stored without a prefix, so an array of them has the same layout in memory as on the wire.
+    template <typename Type> constexpr bool isBulkcopyable = std::is_trivially_copyable_v<Type> && !std::is_same_v<Type, bool> && !isReference<Type>;
 }
 
 struct Bytebuffer
 {
-    std::unique_ptr<uint8_t[]> Internalbuffer;
-    size_t Internalsize{}, Internaliterator{};
+    // Small messages are stored inline and never touch the heap.
+    // The byte after the contents is always zero so that string reads at the very end stay terminated.
+    static constexpr size_t Inlinecapacity = 256;
+
+    std::unique_ptr<uint8_t[]> Heapbuffer;
+    uint8_t Inlinebuffer[Inlinecapacity]{};
+    uint8_t *Internalbuffer{ Inlinebuffer };
+    size_t Internalsize{}, Internalcapacity{ Inlinecapacity }, Internaliterator{};
 
     // Construct the buffer from different containers.
     template <typename Type> Bytebuffer(const std::basic_string<Type> &Data) : Bytebuffer(Data.data(), Data.size()) {}
     template <typename Type> Bytebuffer(const std::vector<Type> &Data) : Bytebuffer(Data.data(), Data.size()) {}
     template <typename Iterator> Bytebuffer(Iterator Begin, Iterator End)
     {
-        Internalbuffer = std::make_unique<uint8_t[]>(std::distance(Begin, End));
-        std::copy(Begin, End, Internalbuffer.get());
+        Reserve(std::distance(Begin, End) + 1);
+        std::copy(Begin, End, Internalbuffer);
         Internalsize = std::distance(Begin, End);
+        Internalbuffer[Internalsize] = 0;
     }
     Bytebuffer(const void *Data, size_t Size)
     {
-        Internalbuffer = std::make_unique<uint8_t[]>(Size + 1);
-        std::memcpy(Internalbuffer.get(), Data, Size);
+        Reserve(Size + 1);
+        std::memcpy(Internalbuffer, Data, Size);
+        Internalbuffer[Size] = 0;
         Internalsize = Size;
     }
     Bytebuffer(const Bytebuffer &Right)
     {
-        Internalsize = Right.Internalsize;
+        Reserve(Right.Internalsize + 1);
+        std::memcpy(Internalbuffer, Right.Internalbuffer, Right.Internalsize);
+        Internalbuffer[Right.Internalsize] = 0;
         Internaliterator = Right.Internaliterator;
-        Internalbuffer = std::make_unique<uint8_t[]>(Internalsize);
-        std::memcpy(Internalbuffer.get(), Right.Internalbuffer.get(), Internalsize);
+        Internalsize = Right.Internalsize;
     }
     Bytebuffer(Bytebuffer &&Right) noexcept
     {
-        Internaliterator = Right.Internaliterator;
-        Internalbuffer.swap(Right.Internalbuffer);
-        Internalsize = Right.Internalsize;
+        *this = std::move(Right);
     }
     Bytebuffer(size_t Size)
     {
-        Internalbuffer = std::make_unique<uint8_t[]>(Size);
+        Reserve(Size + 1);
+        std::memset(Internalbuffer, 0, Size + 1);
         Internalsize = Size;
     }
     Bytebuffer() = default;
 
+    // Grow geometrically so that appending N fields is amortized O(N).
+    void Reserve(size_t Bytecount)
+    {
+        if (Bytecount <= Internalcapacity) [[likely]] return;
+
+        // Includes the terminator.
+        const auto Newcapacity = std::max(Bytecount, Internalcapacity * 2);
+        auto Newbuffer = std::unique_ptr<uint8_t[]>(new uint8_t[Newcapacity]);
+        std::memcpy(Newbuffer.get(), Internalbuffer, Internalsize + 1);
+
+        Heapbuffer.swap(Newbuffer);
+        Internalbuffer = Heapbuffer.get();
+        Internalcapacity = Newcapacity;
+    }
+
     // Basic IO.
     void Rawwrite(size_t Writecount, const void *Buffer = nullptr)
     {
-        // If we are at the end of the buffer, increase it.
-        if (Internaliterator == Internalsize)
+        // If the write extends past the end of the buffer, increase it.
+        if ((Internaliterator + Writecount) > Internalsize)
         {
-            auto Newbuffer = std::make_unique<uint8_t[]>(Internalsize + Writecount);
-            std::memmove(Newbuffer.get(), Internalbuffer.get(), Internalsize);
-            Internalbuffer.swap(Newbuffer);
-            Internalsize += Writecount;
-        }
+            Reserve(Internaliterator + Writecount + 1);
 
-        // If the buffer is already large enough, overwrite.
-        if ((Internaliterator + Writecount) <= Internalsize)
-        {
-            if (Buffer) std::memcpy(Internalbuffer.get() + Internaliterator, Buffer, Writecount);
-            Internaliterator += Writecount;
-            return;
+            // Appended padding is zeroed, overwritten data is left as is.
+            if (!Buffer) std::memset(Internalbuffer + Internalsize, 0, Internaliterator + Writecount - Internalsize);
+            Internalsize = Internaliterator + Writecount;
+            Internalbuffer[Internalsize] = 0;
         }
 
-        // Else we need to make an overwrite and an append call.
-        const size_t Appendcount = Writecount - Remaininglength();
-        const size_t Overwritecount = Remaininglength();
-        Rawwrite(Overwritecount, Buffer);
-        Rawwrite(Appendcount, Buffer ? (uint8_t *)Buffer + Overwritecount : Buffer);
+        if (Buffer) std::memcpy(Internalbuffer + Internaliterator, Buffer, Writecount);
+        Internaliterator += Writecount;
     }
     bool Rawread(size_t Readcount, void *Buffer = nullptr)
     {
@@ -152,12 +176,23 @@ struct Bytebuffer
         if ((Internaliterator + Readcount) > Internalsize) return false;
 
         // Copy the data into the new buffer if provided.
-        if (Buffer) std::memcpy(Buffer, Internalbuffer.get() + Internaliterator, Readcount);
+        if (Buffer) std::memcpy(Buffer, Internalbuffer + Internaliterator, Readcount);
 
         // Advance the internal iterator.
         Internaliterator += Readcount;
         return true;
     }
+    void Varintwrite(uint64_t Value)
+    {
+        uint8_t Encoded[Varint::Maxsize];
+        Rawwrite(Varint::Encode(Value, Encoded), Encoded);
+    }
+    bool Varintread(uint64_t &Value)
+    {
+        const auto Consumed = Varint::Decode(Internalbuffer + Internaliterator, Remaininglength(), Value);
+        Internaliterator += Consumed;
+        return Consumed != 0;
+    }
 
     // Typed IO.
     template <typename Type> void Write(const Type Value, bool Typechecked = true)
@@ -167,7 +202,7 @@ struct Bytebuffer
         // Special case of using a bytebuffer as blob.
         if constexpr (std::is_same<Type, Bytebuffer>::value)
         {
-            Rawwrite(Value.Internalsize, Value.Internalbuffer.get());
+            Rawwrite(Value.Internalsize, Value.Internalbuffer);
             return;
         }
 
@@ -181,7 +216,10 @@ struct Bytebuffer
             Write(uint32_t(sizeof(typename Type::value_type) * Value.size()));
             Write(uint32_t(Value.size()), false);
 
-            for (const auto &Item : Value) Write(Item, false);
+            if constexpr (Internal::isBulkcopyable<typename Type::value_type>)
+                Rawwrite(Value.size() * sizeof(typename Type::value_type), Value.data());
+            else
+                for (const auto &Item : Value) Write(Item, false);
             return;
         }
 
@@ -201,7 +239,26 @@ struct Bytebuffer
             return;
         }
 
-        // POD.
+        // Views are serialized the same way as their owning counterparts.
+        if constexpr (Internal::isDerived<Type, std::basic_string_view>::value)
+        {
+            if constexpr (std::is_same<Type, Blob_view>::value)
+            {
+                Write(uint32_t(Value.size()), Typechecked);
+                Rawwrite(Value.size(), Value.data());
+            }
+            else
+            {
+                constexpr typename Type::value_type Terminator{};
+                Rawwrite(Value.size() * sizeof(typename Type::value_type), Value.data());
+                Rawwrite(sizeof(Terminator), &Terminator);
+            }
+
+            return;
+        }
+
+        // POD, views are handled above.
+        static_assert(!std::is_pointer_v<Type> && !std::is_member_pointer_v<Type>, "Pointers can not be serialized.");
         Rawwrite(sizeof(Type), &Value);
     }
     template <typename Type> bool Read(Type &Buffer, bool Typechecked = true)
@@ -225,11 +282,26 @@ struct Bytebuffer
         // Deserialize as an array.
         if constexpr (Internal::isDerived<Type, std::vector>::value)
         {
-            // Total data-size.
-            Buffer.reserve(Read<uint32_t>(true));
+            using Value_t = typename Type::value_type;
+
+            // Total data-size, implied by the count.
+            (void)Read<uint32_t>(true);
             auto Count = Read<uint32_t>(false);
 
-            while (Count--) Buffer.emplace_back(Read<typename Type::value_type>(false));
+            if constexpr (Internal::isBulkcopyable<Value_t>)
+            {
+                if (Count > Remaininglength() / sizeof(Value_t)) return false;
+
+                const auto Offset = Buffer.size();
+                Buffer.resize(Offset + Count);
+                Rawread(Count * sizeof(Value_t), Buffer.data() + Offset);
+            }
+            else
+            {
+                Buffer.reserve(Buffer.size() + std::min(size_t(Count), Remaininglength()));
+                while (Count--) Buffer.emplace_back(Read<Value_t>(false));
+            }
+
             return !Buffer.empty();
         }
 
@@ -242,7 +314,8 @@ struct Bytebuffer
             return Rawread(Bloblength, Buffer.data());
         }
 
-        // POD.
+        // POD, views need to use Bytebufferview as the memory is not kept.
+        static_assert(!Internal::isReference<Type>, "Pointers and views can not be deserialized from an owning buffer.");
         return Rawread(sizeof(Type), &Buffer);
     }
     template <> bool Read(std::wstring &Buffer, bool Typechecked)
@@ -263,7 +336,7 @@ struct Bytebuffer
             }
         }
 
-        const auto Offset = Internalbuffer.get() + Internaliterator;
+        const auto Offset = Internalbuffer + Internaliterator;
         Buffer = (wchar_t *)Offset;
         return Rawread((Buffer.size() + 1) * sizeof(wchar_t));
     }
@@ -285,7 +358,7 @@ struct Bytebuffer
             }
         }
 
-        const auto Offset = Internalbuffer.get() + Internaliterator;
+        const auto Offset = Internalbuffer + Internaliterator;
         Buffer = (char *)Offset;
         return Rawread((Buffer.size() + 1) * sizeof(char));
     }
@@ -297,10 +370,69 @@ struct Bytebuffer
         return Result;
     }
 
+    // Compact integers, the type-prefix is the same as for the fixed-width encoding.
+    template <typename Type> void Writevarint(const Type Value, bool Typechecked = true)
+    {
+        constexpr auto TypeID = Internal::toID<Type>();
+        if (Typechecked) Rawwrite(sizeof(TypeID), &TypeID);
+
+        Varintwrite(Varint::fromInteger(Value));
+    }
+    template <typename Type> void Writedelta(const Type Value, const Type Previous, bool Typechecked = true)
+    {
+        constexpr auto TypeID = Internal::toID<Type>();
+        if (Typechecked) Rawwrite(sizeof(TypeID), &TypeID);
+
+        Varintwrite(Varint::fromDelta(Value, Previous));
+    }
+    // Compact integers, the type-prefix is the same as for the fixed-width encoding.
+    template <typename Type> bool Readvarint(Type &Buffer, bool Typechecked = true)
+    {
+        constexpr auto TypeID = Internal::toID<Type>();
+        uint8_t Storedtype;
+
+        // Verify the datatype.
+        if (Typechecked)
+        {
+            if (!Rawread(sizeof(uint8_t), &Storedtype))
+                return false;
+
+            if (Storedtype != TypeID)
+            {
+                Internaliterator--;
+                return false;
+            }
+        }
+
+        uint64_t Value{};
+        return Varintread(Value) && Varint::toInteger(Value, Buffer);
+    }
+    template <typename Type> bool Readdelta(Type &Buffer, const Type Previous, bool Typechecked = true)
+    {
+        constexpr auto TypeID = Internal::toID<Type>();
+        uint8_t Storedtype;
+
+        // Verify the datatype.
+        if (Typechecked)
+        {
+            if (!Rawread(sizeof(uint8_t), &Storedtype))
+                return false;
+
+            if (Storedtype != TypeID)
+            {
+                Internaliterator--;
+                return false;
+            }
+        }
+
+        uint64_t Value{};
+        return Varintread(Value) && Varint::toDelta(Value, Previous, Buffer);
+    }
+
     // Utility functionality.
     [[nodiscard]] Blob asBlob() const
     {
-        return { Internalbuffer.get(), Internalsize };
+        return { Internalbuffer, Internalsize };
     }
     [[nodiscard]] void Rewind()
     {
@@ -318,22 +450,39 @@ struct Bytebuffer
     }
     [[nodiscard]] Blob_view asView() const
     {
-        return { Internalbuffer.get(), Internalsize };
+        return { Internalbuffer, Internalsize };
     }
 
     // Supported operators, acts on the internal state.
     bool operator == (const Bytebuffer &Right) const noexcept
     {
         if (Internalsize != Right.Internalsize) return false;
-        return 0 == std::memcmp(Internalbuffer.get(), Right.Internalbuffer.get(), Internalsize);
+        return 0 == std::memcmp(Internalbuffer, Right.Internalbuffer, Internalsize);
     }
     Bytebuffer &operator = (Bytebuffer &&Right) noexcept
     {
         if (this != &Right)
         {
+            // Inline storage can not be stolen, so copy it.
+            if (Right.Heapbuffer)
+            {
+                Heapbuffer = std::move(Right.Heapbuffer);
+                Internalbuffer = Heapbuffer.get();
+                Internalcapacity = Right.Internalcapacity;
+            }
+            else
+            {
+                Heapbuffer.reset();
+                Internalbuffer = Inlinebuffer;
+                Internalcapacity = Inlinecapacity;
+                std::memcpy(Inlinebuffer, Right.Inlinebuffer, Right.Internalsize + 1);
+            }
+
             Internaliterator = std::exchange(Right.Internaliterator, NULL);
-            Internalbuffer = std::exchange(Right.Internalbuffer, nullptr);
             Internalsize = std::exchange(Right.Internalsize, NULL);
+            Right.Internalcapacity = Inlinecapacity;
+            Right.Internalbuffer = Right.Inlinebuffer;
+            Right.Inlinebuffer[0] = 0;
         }
 
         return *this;
@@ -342,8 +491,10 @@ struct Bytebuffer
     {
         if (this != &Right)
         {
-            if (Internalsize != Right.Internalsize) Internalbuffer = std::make_unique<uint8_t[]>(Right.Internalsize);
-            std::memcpy(Internalbuffer.get(), Right.Internalbuffer.get(), Right.Internalsize);
+            Internalsize = 0;
+            Reserve(Right.Internalsize + 1);
+            std::memcpy(Internalbuffer, Right.Internalbuffer, Right.Internalsize);
+            Internalbuffer[Right.Internalsize] = 0;
 
             Internaliterator = Right.Internaliterator;
             Internalsize = Right.Internalsize;
@@ -358,11 +509,192 @@ struct Bytebuffer
     }
     Bytebuffer &operator += (const Bytebuffer &Right) noexcept
     {
-        Rawwrite(Right.Internalsize, Right.Internalbuffer.get());
+        Rawwrite(Right.Internalsize, Right.Internalbuffer);
         return *this;
     }
 };
 
+// Read-only and non-owning, parses directly from a received packet or mapped file.
+// Strings and blobs are returned as views into the underlying memory, which needs to outlive them.
+struct Bytebufferview
+{
+    const uint8_t *Internalbuffer{};
+    size_t Internalsize{}, Internaliterator{};
+
+    Bytebufferview(const void *Data, size_t Size) : Internalbuffer((const uint8_t *)Data), Internalsize(Size) {}
+    Bytebufferview(const Bytebuffer &Buffer) : Bytebufferview(Buffer.Internalbuffer, Buffer.Internalsize) {}
+    template <typename Type> Bytebufferview(const std::basic_string<Type> &Data) : Bytebufferview(Data.data(), Data.size() * sizeof(Type)) {}
+    template <typename Type> Bytebufferview(std::basic_string_view<Type> Data) : Bytebufferview(Data.data(), Data.size() * sizeof(Type)) {}
+    Bytebufferview() = default;
+
+    // Basic IO.
+    bool Rawread(size_t Readcount, void *Buffer = nullptr)
+    {
+        // Range-check, we do not do truncated reads as they are a pain to debug.
+        if ((Internaliterator + Readcount) > Internalsize) return false;
+
+        // Copy the data into the new buffer if provided.
+        if (Buffer) std::memcpy(Buffer, Internalbuffer + Internaliterator, Readcount);
+
+        // Advance the internal iterator.
+        Internaliterator += Readcount;
+        return true;
+    }
+    bool Varintread(uint64_t &Value)
+    {
+        const auto Consumed = Varint::Decode(Internalbuffer + Internaliterator, Remaininglength(), Value);
+        Internaliterator += Consumed;
+        return Consumed != 0;
+    }
+
+    // Typed IO, same format as Bytebuffer.
+    template <typename Type> bool Read(Type &Buffer, bool Typechecked = true)
+    {
+        constexpr auto TypeID = Internal::toID<Type>();
+        uint8_t Storedtype;
+
+        // Verify the datatype.
+        if (Typechecked || TypeID > BB_ARRAY)
+        {
+            if (!Rawread(sizeof(uint8_t), &Storedtype))
+                return false;
+
+            if (Storedtype != TypeID)
+            {
+                Internaliterator--;
+                return false;
+            }
+        }
+
+        // Deserialize as an array.
+        if constexpr (Internal::isDerived<Type, std::vector>::value)
+        {
+            using Value_t = typename Type::value_type;
+
+            // Total data-size, implied by the count.
+            (void)Read<uint32_t>(true);
+            auto Count = Read<uint32_t>(false);
+
+            if constexpr (Internal::isBulkcopyable<Value_t>)
+            {
+                if (Count > Remaininglength() / sizeof(Value_t)) return false;
+
+                const auto Offset = Buffer.size();
+                Buffer.resize(Offset + Count);
+                Rawread(Count * sizeof(Value_t), Buffer.data() + Offset);
+            }
+            else
+            {
+                Buffer.reserve(Buffer.size() + std::min(size_t(Count), Remaininglength()));
+                while (Count--) Buffer.emplace_back(Read<Value_t>(false));
+            }
+
+            return !Buffer.empty();
+        }
+
+        // Blobs, either copied or referenced.
+        else if constexpr (std::is_same<Type, Blob>::value || std::is_same<Type, Blob_view>::value)
+        {
+            const auto Bloblength = Read<uint32_t>(Typechecked);
+            if (Bloblength > Remaininglength()) return false;
+
+            Buffer = Type(Internalbuffer + Internaliterator, Bloblength);
+            return Rawread(Bloblength);
+        }
+
+        // Null-terminated strings, bounded by the end of the buffer.
+        else if constexpr (Internal::isDerived<Type, std::basic_string>::value || Internal::isDerived<Type, std::basic_string_view>::value)
+        {
+            using Char_t = typename Type::value_type;
+            const std::basic_string_view<Char_t> Remaining((const Char_t *)(Internalbuffer + Internaliterator), Remaininglength() / sizeof(Char_t));
+
+            const auto Length = Remaining.find(Char_t{});
+            if (Length == Remaining.npos) return false;
+
+            Buffer = Type(Remaining.substr(0, Length));
+            return Rawread((Length + 1) * sizeof(Char_t));
+        }
+
+        // POD.
+        else
+        {
+            static_assert(!Internal::isReference<Type>, "Pointers can not be deserialized.");
+            return Rawread(sizeof(Type), &Buffer);
+        }
+    }
+    template <typename Type> Type Read(bool Typechecked = true)
+    {
+        Type Result{};
+        if (Typechecked && Peek() == BB_NAN) Rawread(1);
+        else Read(Result, Typechecked);
+        return Result;
+    }
+
+    // Compact integers, the type-prefix is the same as for the fixed-width encoding.
+    template <typename Type> bool Readvarint(Type &Buffer, bool Typechecked = true)
+    {
+        constexpr auto TypeID = Internal::toID<Type>();
+        uint8_t Storedtype;
+
+        // Verify the datatype.
+        if (Typechecked)
+        {
+            if (!Rawread(sizeof(uint8_t), &Storedtype))
+                return false;
+
+            if (Storedtype != TypeID)
+            {
+                Internaliterator--;
+                return false;
+            }
+        }
+
+        uint64_t Value{};
+        return Varintread(Value) && Varint::toInteger(Value, Buffer);
+    }
+    template <typename Type> bool Readdelta(Type &Buffer, const Type Previous, bool Typechecked = true)
+    {
+        constexpr auto TypeID = Internal::toID<Type>();
+        uint8_t Storedtype;
+
+        // Verify the datatype.
+        if (Typechecked)
+        {
+            if (!Rawread(sizeof(uint8_t), &Storedtype))
+                return false;
+
+            if (Storedtype != TypeID)
+            {
+                Internaliterator--;
+                return false;
+            }
+        }
+
+        uint64_t Value{};
+        return Varintread(Value) && Varint::toDelta(Value, Previous, Buffer);
+    }
+
+    // Utility functionality.
+    void Rewind()
+    {
+        Internaliterator = 0;
+    }
+    [[nodiscard]] uint8_t Peek()
+    {
+        const auto Byte = Read<uint8_t>(false);
+        if (Byte != BB_NONE) Internaliterator--;
+        return Byte;
+    }
+    [[nodiscard]] size_t Remaininglength() const
+    {
+        return Internalsize - Internaliterator;
+    }
+    [[nodiscard]] Blob_view asView() const
+    {
+        return { Internalbuffer, Internalsize };
+    }
+};
+
 #pragma region Extensions
 // Interface for serializable objects.
 struct ISerializable
@@ -413,5 +745,279 @@ inline Blob bbSerialize(ISerializable &&Object)
     return Tempbuffer.asBlob();
 }
 
+#pragma endregion
+
+#pragma region Schemas
+// Packed serialization for structs that declare their fields once:
+// struct Player { uint32_t ID; std::string Name; std::vector<float> Stats; static constexpr auto Schema = bbSchema(&Player::ID, &Player::Name, &Player::Stats); };
+// bbPack(Buffer, Object) and bbUnpack(Buffer, Object) then need no hand-written code.
+// Integer fields can opt into compact encodings, e.g. bbVarint(&Player::ID) or bbDelta(&Player::Timestamps).
+template <typename... Entries> struct bbSchema;
+
+enum class bbEncoding : uint8_t { Fixed, Varint, Delta };
+template <bbEncoding Encoding, typename Class, typename Member> struct bbField { Member Class::*Pointer; };
+
+// LEB128 / zigzag for integers and integer arrays, deltas to the previous element for sorted arrays.
+template <typename Class, typename Member> constexpr auto bbVarint(Member Class::*Pointer) { return bbField<bbEncoding::Varint, Class, Member>{ Pointer }; }
+template <typename Class, typename Member> constexpr auto bbDelta(Member Class::*Pointer) { return bbField<bbEncoding::Delta, Class, Member>{ Pointer }; }
+
+namespace Internal
+{
+    template <typename Type> concept hasSchema = requires { Type::Schema; };
+
+    // Plain member-pointers are fixed-width.
+    template <typename Entry> struct Fieldtraits;
+    template <typename Class, typename Member> struct Fieldtraits<Member Class::*>
+    {
+        using Type = Member;
+        static constexpr auto Encoding = bbEncoding::Fixed;
+        static constexpr auto Pointer(Member Class::*Entry) { return Entry; }
+    };
+    template <bbEncoding Fieldencoding, typename Class, typename Member> struct Fieldtraits<bbField<Fieldencoding, Class, Member>>
+    {
+        using Type = Member;
+        static constexpr auto Encoding = Fieldencoding;
+        static constexpr auto Pointer(bbField<Fieldencoding, Class, Member> Entry) { return Entry.Pointer; }
+    };
+
+    // A compatible layout is one with the same field types in the same order.
+    template <typename Type> constexpr uint32_t Schematypehash()
+    {
+        if constexpr (hasSchema<Type>) return decltype(Type::Schema)::Hash;
+        else if constexpr (isDerived<Type, std::vector>::value) return BB_ARRAY ^ (Schematypehash<typename Type::value_type>() * Hash::Internal::FNV1_Prime_32);
+        else if constexpr (toID<Type>() != BB_NONE) return toID<Type>();
+        else return uint32_t(sizeof(Type) << 8);
+    }
+    template <typename Entry> constexpr uint32_t Fieldhash()
+    {
+        using Traits = Fieldtraits<Entry>;
+        return Schematypehash<typename Traits::Type>() ^ (uint32_t(Traits::Encoding) << 24);
+    }
+
+    template <typename Class, typename Entry> void Packentry(Bytebuffer &Buffer, const Class &Object, const Entry &Field, bool Trusted);
+    template <typename Reader, typename Class, typename Entry> bool Unpackentry(Reader &Buffer, Class &Object, const Entry &Field, bool Trusted);
+
+    // Fields are written as is, the optional type-prefix is the only difference between trusted and checked mode.
+    template <typename Type> void Packfield(Bytebuffer &Buffer, const Type &Value, bool Trusted)
+    {
+        if (!Trusted)
+        {
+            constexpr auto TypeID = toID<Type>();
+            Buffer.Rawwrite(sizeof(TypeID), &TypeID);
+        }
+
+        if constexpr (hasSchema<Type>)
+        {
+            std::apply([&](const auto &... Fields) { (Packentry(Buffer, Value, Fields, Trusted), ...); }, Type::Schema.Fields);
+        }
+        else if constexpr (isDerived<Type, std::vector>::value)
+        {
+            const auto Count = uint32_t(Value.size());
+            Buffer.Rawwrite(sizeof(Count), &Count);
+
+            if constexpr (isBulkcopyable<typename Type::value_type>)
+                Buffer.Rawwrite(Value.size() * sizeof(typename Type::value_type), Value.data());
+            else
+                for (const auto &Item : Value) Packfield(Buffer, Item, Trusted);
+        }
+        else if constexpr (isDerived<Type, std::basic_string>::value || isDerived<Type, std::basic_string_view>::value)
+        {
+            const auto Count = uint32_t(Value.size());
+            Buffer.Rawwrite(sizeof(Count), &Count);
+            Buffer.Rawwrite(Value.size() * sizeof(typename Type::value_type), Value.data());
+        }
+        else
+        {
+            static_assert(std::is_trivially_copyable_v<Type>, "Field needs a schema of its own.");
+            static_assert(!isReference<Type>, "Pointers can not be serialized.");
+            Buffer.Rawwrite(sizeof(Type), &Value);
+        }
+    }
+
+    // Works on Bytebuffer and Bytebufferview, views can only be read from the latter as the memory is not copied.
+    template <typename Reader, typename Type> bool Unpackfield(Reader &Buffer, Type &Value, bool Trusted)
+    {
+        if (!Trusted)
+        {
+            uint8_t Storedtype{};
+            if (!Buffer.Rawread(sizeof(Storedtype), &Storedtype)) return false;
+            if (Storedtype != toID<Type>()) return false;
+        }
+
+        if constexpr (hasSchema<Type>)
+        {
+            return std::apply([&](const auto &... Fields) { return (Unpackentry(Buffer, Value, Fields, Trusted) && ...); }, Type::Schema.Fields);
+        }
+        else if constexpr (isDerived<Type, std::vector>::value)
+        {
+            using Value_t = typename Type::value_type;
+
+            uint32_t Count{};
+            if (!Buffer.Rawread(sizeof(Count), &Count)) return false;
+
+            if constexpr (isBulkcopyable<Value_t>)
+            {
+                if (Count > Buffer.Remaininglength() / sizeof(Value_t)) return false;
+
+                Value.resize(Count);
+                return Buffer.Rawread(Count * sizeof(Value_t), Value.data());
+            }
+            else
+            {
+                Value.clear();
+                Value.reserve(std::min(size_t(Count), Buffer.Remaininglength()));
+
+                while (Count--) if (!Unpackfield(Buffer, Value.emplace_back(), Trusted)) return false;
+                return true;
+            }
+        }
+        else if constexpr (isDerived<Type, std::basic_string>::value || isDerived<Type, std::basic_string_view>::value)
+        {
+            using Char_t = typename Type::value_type;
+            static_assert(!isDerived<Type, std::basic_string_view>::value || !std::is_same_v<std::remove_cv_t<Reader>, Bytebuffer>,
+                          "Views can not be deserialized from an owning buffer, use a Bytebufferview.");
+
+            uint32_t Count{};
+            if (!Buffer.Rawread(sizeof(Count), &Count)) return false;
+            if (Count > Buffer.Remaininglength() / sizeof(Char_t)) return false;
+
+            Value = Type((const Char_t *)(Buffer.Internalbuffer + Buffer.Internaliterator), Count);
+            return Buffer.Rawread(Count * sizeof(Char_t));
+        }
+        else
+        {
+            static_assert(!isReference<Type>, "Pointers can not be deserialized.");
+            return Buffer.Rawread(sizeof(Type), &Value);
+        }
+    }
+    // Counts are varints as well, every element takes at least a byte so they are bounded by the remaining length.
+    template <bbEncoding Encoding, typename Type> void Packencoded(Bytebuffer &Buffer, const Type &Value, bool Trusted)
+    {
+        static_assert(Encoding != bbEncoding::Delta || isDerived<Type, std::vector>::value, "Delta-encoding is for arrays.");
+
+        if (!Trusted)
+        {
+            constexpr auto TypeID = toID<Type>();
+            Buffer.Rawwrite(sizeof(TypeID), &TypeID);
+        }
+
+        if constexpr (isDerived<Type, std::vector>::value)
+        {
+            typename Type::value_type Previous{};
+            Buffer.Varintwrite(Value.size());
+
+            for (const auto &Item : Value)
+            {
+                if constexpr (Encoding == bbEncoding::Delta) Buffer.Varintwrite(Varint::fromDelta(Item, Previous));
+                else Buffer.Varintwrite(Varint::fromInteger(Item));
+                Previous = Item;
+            }
+        }
+        else
+        {
+            Buffer.Varintwrite(Varint::fromInteger(Value));
+        }
+    }
+    template <bbEncoding Encoding, typename Reader, typename Type> bool Unpackencoded(Reader &Buffer, Type &Value, bool Trusted)
+    {
+        if (!Trusted)
+        {
+            uint8_t Storedtype{};
+            if (!Buffer.Rawread(sizeof(Storedtype), &Storedtype)) return false;
+            if (Storedtype != toID<Type>()) return false;
+        }
+
+        uint64_t Encoded{};
+        if constexpr (isDerived<Type, std::vector>::value)
+        {
+            if (!Buffer.Varintread(Encoded)) return false;
+            if (Encoded > Buffer.Remaininglength()) return false;
+
+            typename Type::value_type Previous{};
+            Value.resize(size_t(Encoded));
+
+            for (auto &Item : Value)
+            {
+                if (!Buffer.Varintread(Encoded)) return false;
+
+                if constexpr (Encoding == bbEncoding::Delta) { if (!Varint::toDelta(Encoded, Previous, Item)) return false; }
+                else { if (!Varint::toInteger(Encoded, Item)) return false; }
+                Previous = Item;
+            }
+
+            return true;
+        }
+        else
+        {
+            return Buffer.Varintread(Encoded) && Varint::toInteger(Encoded, Value);
+        }
+    }
+
+    template <typename Class, typename Entry> void Packentry(Bytebuffer &Buffer, const Class &Object, const Entry &Field, bool Trusted)
+    {
+        using Traits = Fieldtraits<Entry>;
+        const auto &Value = Object.*Traits::Pointer(Field);
+
+        if constexpr (Traits::Encoding == bbEncoding::Fixed) Packfield(Buffer, Value, Trusted);
+        else Packencoded<Traits::Encoding>(Buffer, Value, Trusted);
+    }
+    template <typename Reader, typename Class, typename Entry> bool Unpackentry(Reader &Buffer, Class &Object, const Entry &Field, bool Trusted)
+    {
+        using Traits = Fieldtraits<Entry>;
+        auto &Value = Object.*Traits::Pointer(Field);
+
+        if constexpr (Traits::Encoding == bbEncoding::Fixed) return Unpackfield(Buffer, Value, Trusted);
+        else return Unpackencoded<Traits::Encoding>(Buffer, Value, Trusted);
+    }
+}
+
+template <typename... Entries> struct bbSchema
+{
+    std::tuple<Entries...> Fields;
+    constexpr bbSchema(Entries... Input) : Fields(Input...) {}
+
+    // FNV1a over the field-layout, changes when fields are added, removed, reordered, change type or encoding.
+    static constexpr uint32_t Hash = []()
+    {
+        uint32_t Result = ::Hash::Internal::FNV1_Offset_32;
+        ((Result = (Result ^ Internal::Fieldhash<Entries>()) * ::Hash::Internal::FNV1_Prime_32), ...);
+        return Result;
+    }();
+};
+
+// The header is the schema-hash, inverted for checked mode so that mismatched readers fail early.
+template <typename Type> void bbPack(Bytebuffer &Buffer, const Type &Object, bool Trusted = true)
+{
+    static_assert(Internal::hasSchema<Type>, "Type needs a static constexpr Schema member.");
+
+    const uint32_t Header = Trusted ? decltype(Type::Schema)::Hash : ~decltype(Type::Schema)::Hash;
+    Buffer.Reserve(Buffer.Internaliterator + sizeof(Header) + sizeof(Type));
+    Buffer.Rawwrite(sizeof(Header), &Header);
+
+    std::apply([&](const auto &... Fields) { (Internal::Packentry(Buffer, Object, Fields, Trusted), ...); }, Type::Schema.Fields);
+}
+template <typename Type, typename Reader> bool bbUnpack(Reader &Buffer, Type &Object, bool Trusted = true)
+{
+    static_assert(Internal::hasSchema<Type>, "Type needs a static constexpr Schema member.");
+
+    uint32_t Header{};
+    const auto Offset = Buffer.Internaliterator;
+    if (!Buffer.Rawread(sizeof(Header), &Header)) return false;
+
+    if (Header != (Trusted ? decltype(Type::Schema)::Hash : ~decltype(Type::Schema)::Hash))
+    {
+        Buffer.Internaliterator = Offset;
+        return false;
+    }
+
+    return std::apply([&](const auto &... Fields) { return (Internal::Unpackentry(Buffer, Object, Fields, Trusted) && ...); }, Type::Schema.Fields);
+}
+template <typename Type> Blob bbPack(const Type &Object, bool Trusted = true)
+{
+    Bytebuffer Tempbuffer;
+    bbPack(Tempbuffer, Object, Trusted);
+    return Tempbuffer.asBlob();
+}
+
 #pragma endregion
 #pragma warning(pop)
@@ -0,0 +1,180 @@
+/*
+    Initial author: Convery (tcn@ayria.se)
+    Started: 2020-11-06
+    License: MIT
+
+    LEB128 variable-length integers, 7 bits per byte with the MSB as continuation.
+    Signed values are zigzag-mapped first so that small negatives stay small.
+*/
+
+#pragma once
+#include <bit>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace Varint
+{
+    constexpr size_t Maxsize = 10;
+
+    [[nodiscard]] constexpr uint64_t Zigzag(int64_t Value)
+    {
+        return (uint64_t(Value) << 1) ^ uint64_t(Value >> 63);
+    }
+    [[nodiscard]] constexpr int64_t Unzigzag(uint64_t Value)
+    {
+        return int64_t(Value >> 1) ^ -int64_t(Value & 1);
+    }
+    [[nodiscard]] constexpr size_t Encodesize(uint64_t Value)
+    {
+        return 1 + (std::bit_width(Value | 1) - 1) / 7;
+    }
+
+    // Output needs room for Maxsize bytes, returns the bytes written.
+    constexpr size_t Encode(uint64_t Value, uint8_t *Output)
+    {
+        size_t Written{};
+
+        while (Value >= 0x80)
+        {
+            Output[Written++] = uint8_t(Value | 0x80);
+            Value >>= 7;
+        }
+
+        Output[Written++] = uint8_t(Value);
+        return Written;
+    }
+
+    namespace Internal
+    {
+        // Returns the bytes consumed, 0 if the input is truncated, does not fit in 64 bits or is not the shortest encoding.
+        [[nodiscard]] constexpr size_t Decode_scalar(const uint8_t *Input, size_t Length, uint64_t &Value)
+        {
+            uint64_t Result{};
+
+            for (size_t i = 0; i < Length && i < Maxsize; ++i)
+            {
+                // The tenth byte only has room for the top bit.
+                if (i == Maxsize - 1 && Input[i] > 1) return 0;
+
+                Result |= uint64_t(Input[i] & 0x7F) << (7 * i);
+                if (!(Input[i] & 0x80))
+                {
+                    // A zero final byte only pads a shorter value.
+                    if (i && !Input[i]) return 0;
+
+                    Value = Result;
+                    return i + 1;
+                }
+            }
+
+            return 0;
+        }
+    }
+
+    // Decodes up to 8 bytes per step, the common case is branch-free after the initial load.
+    [[nodiscard]] inline size_t Decode(const uint8_t *Input, size_t Length, uint64_t &Value)
+    {
+        if (Length >= sizeof(uint64_t)) [[likely]]
+        {
+            uint64_t Word;
+            std::memcpy(&Word, Input, sizeof(Word));
+
+            // The first byte without the continuation bit ends the value.
+            if (const auto Stops = ~Word & 0x8080808080808080ULL)
+            {
+                const auto Bytecount = size_t(std::countr_zero(Stops) + 1) / 8;
+                // Overlong, as in the scalar path.
+                if (Bytecount > 1 && !((Word >> (Bytecount * 8 - 8)) & 0xFF)) return 0;
+                if (Bytecount < sizeof(uint64_t)) Word &= (uint64_t(1) << (Bytecount * 8)) - 1;
+
+                // Compact the 7-bit groups, doubling the lane width each step.
+                Word = (Word & 0x007F007F007F007FULL) | ((Word & 0x7F007F007F007F00ULL) >> 1);
+                Word = (Word & 0x00003FFF00003FFFULL) | ((Word & 0x3FFF00003FFF0000ULL) >> 2);
+                Word = (Word & 0x000000000FFFFFFFULL) | ((Word & 0x0FFFFFFF00000000ULL) >> 4);
+
+                Value = Word;
+                return Bytecount;
+            }
+        }
+
+        return Internal::Decode_scalar(Input, Length, Value);
+    }
+
+    // Integers and enumerations to the unsigned representation and back, with range-checking on the way back.
+    template <typename Type> [[nodiscard]] constexpr uint64_t fromInteger(Type Value)
+    {
+        if constexpr (std::is_enum_v<Type>) return fromInteger(std::underlying_type_t<Type>(Value));
+        else
+        {
+            static_assert(std::is_integral_v<Type> && !std::is_same_v<Type, bool>, "Varints are for integers.");
+
+            if constexpr (std::is_signed_v<Type>) return Zigzag(int64_t(Value));
+            else return uint64_t(Value);
+        }
+    }
+    template <typename Type> [[nodiscard]] constexpr bool toInteger(uint64_t Value, Type &Output)
+    {
+        if constexpr (std::is_enum_v<Type>)
+        {
+            std::underlying_type_t<Type> Temp{};
+            if (!toInteger(Value, Temp)) return false;
+
+            Output = Type(Temp);
+            return true;
+        }
+        else
+        {
+            static_assert(std::is_integral_v<Type> && !std::is_same_v<Type, bool>, "Varints are for integers.");
+
+            if constexpr (std::is_signed_v<Type>)
+            {
+                const auto Signed = Unzigzag(Value);
+                if (Signed < std::numeric_limits<Type>::min() || Signed > std::numeric_limits<Type>::max()) return false;
+                Output = Type(Signed);
+            }
+            else
+            {
+                if (Value > std::numeric_limits<Type>::max()) return false;
+                Output = Type(Value);
+            }
+
+            return true;
+        }
+    }
+
+    // Difference to a previous value, wrapping so that it round-trips for any pair.
+    template <typename Type> [[nodiscard]] constexpr uint64_t fromDelta(Type Value, Type Previous)
+    {
+        if constexpr (std::is_enum_v<Type>) return fromDelta(std::underlying_type_t<Type>(Value), std::underlying_type_t<Type>(Previous));
+        else
+        {
+            using Unsigned_t = std::make_unsigned_t<Type>;
+            using Signed_t = std::make_signed_t<Type>;
+            return Zigzag(int64_t(Signed_t(Unsigned_t(Unsigned_t(Value) - Unsigned_t(Previous)))));
+        }
+    }
+    template <typename Type> [[nodiscard]] constexpr bool toDelta(uint64_t Value, Type Previous, Type &Output)
+    {
+        if constexpr (std::is_enum_v<Type>)
+        {
+            std::underlying_type_t<Type> Temp{};
+            if (!toDelta(Value, std::underlying_type_t<Type>(Previous), Temp)) return false;
+
+            Output = Type(Temp);
+            return true;
+        }
+        else
+        {
+            using Unsigned_t = std::make_unsigned_t<Type>;
+            using Signed_t = std::make_signed_t<Type>;
+
+            Signed_t Delta{};
+            if (!toInteger(Value, Delta)) return false;
+
+            Output = Type(Unsigned_t(Unsigned_t(Previous) + Unsigned_t(Delta)));
+            return true;
+        }
+    }
+}
@@ -0,0 +1,171 @@
+/*
+    Initial author: Convery (tcn@ayria.se)
+    Started: 2020-11-14
+    License: MIT
+
+    Persistent pattern-scan results, keyed by a fingerprint of the scanned range.
+    Cached offsets are re-compared before use, stale entries fall back to a full scan.
+
+    Patternscan::Patterncache_t Cache{};
+    const auto Address = Cache.Findpattern(Textsegment, "48 8B 05 ? ? ? ? C3");
+*/
+
+#pragma once
+#include <Stdinclude.hpp>
+#include "Patternscan.hpp"
+#include "../Wrappers/Filesystem.hpp"
+
+namespace Patternscan
+{
+    // Size plus CRC of the first 64 KiB and 64 evenly spaced 4 KiB samples, cheap enough for every launch.
+    [[nodiscard]] inline uint64_t Fingerprint(const Range_t &Range)
+    {
+        constexpr size_t Headersize = 64 * 1024, Samplesize = 4096, Samplecount = 64;
+        const auto Base = (const uint8_t *)Range.first;
+        const auto Size = size_t(Range.second - Range.first);
+
+        auto Checksum = Hash::Internal::CRC32B_Update(0xFFFFFFFF, Base, std::min(Size, Headersize));
+        if (Size > Headersize + Samplesize)
+        {
+            const auto Stride = (Size - Headersize - Samplesize) / Samplecount;
+            for (size_t i = 1; i <= Samplecount; ++i)
+                Checksum = Hash::Internal::CRC32B_Update(Checksum, Base + Headersize + Stride * i, Samplesize);
+        }
+
+        return (uint64_t(Size) << 32) ^ uint64_t(~Checksum);
+    }
+
+    struct Patterncache_t
+    {
+        static constexpr uint32_t Version = Hash::FNV1_32("Patterncache_v1");
+        struct Entry_t { uint64_t Fingerprint, Patternhash; std::vector<uint64_t> Offsets; };
+
+        std::unordered_map<uint64_t, Entry_t> Entries;
+        std::string Path;
+        bool isDirty{};
+
+        // Only ranges that produced results are cached, absence can not be re-validated.
+        void Store(uint64_t Fingerprint, uint64_t Patternhash, const Range_t &Range, const std::vector<std::uintptr_t> &Results)
+        {
+            Entry_t Entry{ Fingerprint, Patternhash, {} };
+            Entry.Offsets.reserve(Results.size());
+            for (const auto &Address : Results) Entry.Offsets.push_back(Address - Range.first);
+
+            Entries[Fingerprint ^ Patternhash] = std::move(Entry);
+            isDirty = true;
+        }
+        [[nodiscard]] const Entry_t *Lookup(uint64_t Fingerprint, uint64_t Patternhash, const Range_t &Range, Patternmask_view Pattern, Patternmask_view Mask) const
+        {
+            const auto Result = Entries.find(Fingerprint ^ Patternhash);
+            if (Result == Entries.end()) return nullptr;
+
+            const auto &Entry = Result->second;
+            if (Entry.Fingerprint != Fingerprint || Entry.Patternhash != Patternhash) return nullptr;
+            if (Entry.Offsets.empty()) return nullptr;
+
+            // Re-compare the bytes at every offset.
+            const Internal::Matcher_t Matcher(Pattern, Mask);
+            const auto Size = size_t(Range.second - Range.first);
+            for (const auto &Offset : Entry.Offsets)
+            {
+                if (Offset > Size || Size - Offset < Pattern.size()) return nullptr;
+                if (!Matcher.Compare((const uint8_t *)Range.first + Offset)) return nullptr;
+            }
+
+            return &Entry;
+        }
+        [[nodiscard]] static uint64_t Patternhash(Patternmask_view Pattern, Patternmask_view Mask, bool isSingle)
+        {
+            const auto Patternpart = Hash::FNV1a_64(Pattern.data(), Pattern.size());
+            const auto Maskpart = Hash::FNV1a_64(Mask.data(), Mask.size());
+            return (Patternpart * 31 + Maskpart) ^ uint64_t(isSingle);
+        }
+
+        explicit Patterncache_t(std::string_view Filepath = "./Ayria/Assets/Patterncache.bin") : Path(Filepath)
+        {
+            const auto Filebuffer = FS::Readfile(Path);
+            if (Filebuffer.empty()) return;
+
+            Bytebuffer Reader(Filebuffer);
+            if (Reader.Read<uint32_t>() != Version) return;
+
+            const auto Count = Reader.Read<uint32_t>();
+            for (uint32_t i = 0; i < Count; ++i)
+            {
+                Entry_t Entry{};
+                if (!Reader.Read(Entry.Fingerprint) || !Reader.Read(Entry.Patternhash) || !Reader.Read(Entry.Offsets)) break;
+
+                // Never stored by us, so the file is damaged.
+                if (Entry.Offsets.empty()) continue;
+                Entries[Entry.Fingerprint ^ Entry.Patternhash] = std::move(Entry);
+            }
+        }
+        ~Patterncache_t() { if (isDirty) Save(); }
+
+        bool Save()
+        {
+            Bytebuffer Writer;
+            Writer.Write(Version);
+            Writer.Write(uint32_t(Entries.size()));
+
+            for (const auto &[_, Entry] : Entries)
+            {
+                Writer.Write(Entry.Fingerprint);
+                Writer.Write(Entry.Patternhash);
+                Writer.Write(Entry.Offsets);
+            }
+
+            isDirty = false;
+            return FS::Writefileatomic(Path, Writer.asBlob());
+        }
+
+        // Same semantics as the uncached scanners.
+        [[nodiscard]] std::uintptr_t Findpattern(const Range_t &Range, Patternmask_view Pattern, Patternmask_view Mask)
+        {
+            const auto Rangeprint = Fingerprint(Range);
+            const auto Key = Patternhash(Pattern, Mask, true);
+
+            if (const auto Entry = Lookup(Rangeprint, Key, Range, Pattern, Mask))
+                return Range.first + std::uintptr_t(Entry->Offsets.front());
+
+            const auto Result = Patternscan::Findpattern(Range, Pattern, Mask);
+            if (Result) Store(Rangeprint, Key, Range, { Result });
+            return Result;
+        }
+        [[nodiscard]] std::vector<std::uintptr_t> Findpatterns(const Range_t &Range, Patternmask_view Pattern, Patternmask_view Mask)
+        {
+            const auto Rangeprint = Fingerprint(Range);
+            const auto Key = Patternhash(Pattern, Mask, false);
+
+            if (const auto Entry = Lookup(Rangeprint, Key, Range, Pattern, Mask))
+            {
+                std::vector<std::uintptr_t> Results;
+                Results.reserve(Entry->Offsets.size());
+                for (const auto &Offset : Entry->Offsets) Results.push_back(Range.first + std::uintptr_t(Offset));
+                return Results;
+            }
+
+            const auto Results = Patternscan::Findpatterns(Range, Pattern, Mask);
+            if (!Results.empty()) Store(Rangeprint, Key, Range, Results);
+            return Results;
+        }
+        [[nodiscard]] std::uintptr_t Findpattern(const Range_t &Range, std::string IDAPattern)
+        {
+            const auto [Pattern, Mask] = from_IDA(std::move(IDAPattern));
+            return Findpattern(Range, Pattern, Mask);
+        }
+        [[nodiscard]] std::vector<std::uintptr_t> Findpatterns(const Range_t &Range, std::string IDAPattern)
+        {
+            const auto [Pattern, Mask] = from_IDA(std::move(IDAPattern));
+            return Findpatterns(Range, Pattern, Mask);
+        }
+        template <size_t N> [[nodiscard]] std::uintptr_t Findpattern(const Range_t &Range, const Patternliteral_t<N> &Literal)
+        {
+            return Findpattern(Range, Literal.Patternview(), Literal.Maskview());
+        }
+        template <size_t N> [[nodiscard]] std::vector<std::uintptr_t> Findpatterns(const Range_t &Range, const Patternliteral_t<N> &Literal)
+        {
+            return Findpatterns(Range, Literal.Patternview(), Literal.Maskview());
+        }
+    };
+}
@@ -5,10 +5,12 @@
 
     const auto [Textsegment, Datasegment] = Defaultranges();
     for(const auto &Address : Findpatterns(Datasegment, "25 64 ? 25")) {}
+    const auto Address = Findpattern(Textsegment, Patternliteral_t("48 8B ? ? 89"));
 */
 
 #pragma once
 #include <Stdinclude.hpp>
+#include "../Internal/Cpufeatures.hpp"
 
 // GCC exported.
 #if !defined(_WIN32)
@@ -21,68 +23,202 @@ namespace Patternscan
     using Patternmask_view = std::basic_string_view<uint8_t>;
     using Patternmask_t = std::basic_string<uint8_t>;
 
-    // Find a single pattern in a range.
-    [[nodiscard]] inline std::uintptr_t Findpattern(const Range_t &Range, Patternmask_view Pattern, Patternmask_view Mask)
+    namespace Internal
     {
-        assert(Pattern.size() == Mask.size());
-        assert(Pattern.size() != 0);
-        assert(Range.second != 0);
-        assert(Range.first != 0);
-        assert(Mask[0] != 0); // The first byte can't be a wildcard.
+        // Rank of each byte-value by frequency in x86-64 code, 0 is the rarest.
+        // Measured over the .text sections of ~80 common binaries (360MB).
+        constexpr uint8_t Byterank[256] =
+        {
+            255, 248, 229, 219, 233, 218, 176, 186, 237, 151, 122, 143, 181, 138,  96, 251,
+            236, 194,  91,  74, 159, 200,  89,  68, 221,  58,  46,  41, 114,  76,  59, 230,
+            224, 112,  43,  32, 250, 153,  23,  33, 216, 192,  28,  93, 101,  72, 163,  37,
+            206, 226,  26,  52, 109, 137,  25,  51, 199, 223,  45, 139, 145, 156,  40,  75,
+            232, 244, 113, 180, 243, 222, 121, 144, 254, 240,  86,  82, 247, 213,  62,  67,
+            205,  44,  36, 174, 203, 191, 129, 134, 152,  24,  21, 177, 188, 197, 133, 128,
+            170,  73, 190,  98, 147,  63, 238,  47, 140,  56,  38,  65, 141,  66,  79, 187,
+            198,  31, 119, 115, 234, 217,  80, 102, 150,  39,  27, 106, 204, 146, 142, 158,
+            215, 171,  54, 242, 241, 239,  57,  90, 167, 252,  48, 249, 116, 245,  34,  30,
+            201,  15,  16,  20, 126,  71,  10,  13, 108,  19,   0,   3,  70,  22,   2,   7,
+            118,  84,   8,  18,  35,  12,   6,   5, 111,   9,  29,  14,  78,  11,   1,  42,
+            127,  53,   4,  17, 110,  49, 157, 120, 183, 131, 184,  60, 168, 100, 185, 130,
+            235, 225, 175, 220, 210, 208, 207, 227, 178, 166,  97,  50,  85,  61,  77,  64,
+            179, 123, 173, 103,  69,  87,  95,  88, 169,  92,  94, 132,  55,  83, 117, 196,
+            193, 148, 136,  99, 105, 107, 124, 160, 246, 228, 125, 214, 154, 149, 155, 202,
+            189, 104, 135, 182,  81, 165, 211, 195, 209, 162, 172, 161, 164, 212, 231, 253
+        };
 
-        size_t Count = Range.second - Range.first - Pattern.size();
-        auto Base = (const uint8_t *)Range.first;
-        const uint8_t Firstbyte = Pattern[0];
+        // The two rarest non-wildcard bytes, all wildcards matches anywhere and a single byte anchors twice.
+        [[nodiscard]] constexpr std::pair<size_t, size_t> Selectanchors(Patternmask_view Pattern, Patternmask_view Mask)
+        {
+            size_t Best = SIZE_MAX, Second = SIZE_MAX;
+            for (size_t i = 0; i < Mask.size(); ++i)
+            {
+                if (!Mask[i]) continue;
+
+                if (Best == SIZE_MAX || Byterank[Pattern[i]] < Byterank[Pattern[Best]]) { Second = Best; Best = i; }
+                else if (Second == SIZE_MAX || Byterank[Pattern[i]] < Byterank[Pattern[Second]]) Second = i;
+            }
+
+            const auto First = Best == SIZE_MAX ? 0 : Best;
+            return { First, Second == SIZE_MAX ? First : Second };
+        }
 
-        // Inline compare.
-        const auto Compare = [&](const uint8_t *Address) -> bool
+        // Precomputed once per pattern, anchored on the two rarest non-wildcard bytes.
+        struct Matcher_t
         {
-            const size_t Patternlength = Pattern.size();
-            for (size_t i = 1; i < Patternlength; ++i)
+            Patternmask_view Pattern, Mask;
+            size_t Firstanchor{}, Secondanchor{};
+
+            // Zero-padded to a multiple of 32 for the vector compare.
+            alignas(32) uint8_t Patternbytes[256]{};
+            alignas(32) uint8_t Maskbytes[256]{};
+            size_t Vectorsize{};
+
+            Matcher_t(Patternmask_view Patternview, Patternmask_view Maskview) : Matcher_t(Patternview, Maskview, Selectanchors(Patternview, Maskview)) {}
+            Matcher_t(Patternmask_view Patternview, Patternmask_view Maskview, std::pair<size_t, size_t> Anchors)
+                : Pattern(Patternview), Mask(Maskview), Firstanchor(Anchors.first), Secondanchor(Anchors.second)
             {
-                if (Mask[i] && Address[i] != Pattern[i])
-                    return false;
+                assert(Pattern.size() == Mask.size());
+                assert(Pattern.size() != 0);
+
+                if (Pattern.size() <= sizeof(Patternbytes))
+                {
+                    Vectorsize = (Pattern.size() + 31) & ~size_t(31);
+                    for (size_t i = 0; i < Pattern.size(); ++i)
+                    {
+                        Maskbytes[i] = Mask[i] ? 0xFF : 0x00;
+                        Patternbytes[i] = Pattern[i] & Maskbytes[i];
+                    }
+                }
+            }
+
+            [[nodiscard]] bool Compare(const uint8_t *Address) const
+            {
+                const size_t Patternlength = Pattern.size();
+                for (size_t i = 0; i < Patternlength; ++i)
+                {
+                    if (Mask[i] && Address[i] != Pattern[i])
+                        return false;
+                }
+                return true;
             }
-            return true;
         };
 
-        while (true)
+        // Returns the first match starting in [Begin, End - Patternsize], or nullptr.
+        [[nodiscard]] inline const uint8_t *Find_scalar(const Matcher_t &Matcher, const uint8_t *Begin, const uint8_t *End)
         {
-            // Use memchr as the compiler can use an optimized scan rather than a for loop.
-            auto Piviot = (const uint8_t *)std::memchr(Base, Firstbyte, Count);
+            if (size_t(End - Begin) < Matcher.Pattern.size()) return nullptr;
 
-            // No more bytes in the range.
-            if (!Piviot) [[unlikely]]
-                return 0;
+            const auto Anchor = Matcher.Firstanchor;
+            const auto Anchorbyte = Matcher.Mask[Anchor] ? Matcher.Pattern[Anchor] : 0;
+            const auto Last = End - Matcher.Pattern.size();
 
-            // Rare case that something is found.
-            if (Compare(Piviot)) [[unlikely]]
-                return std::uintptr_t(Piviot);
+            // All wildcards.
+            if (!Matcher.Mask[Anchor]) return Begin;
+
+            auto Base = Begin;
+            while (Base <= Last)
+            {
+                // Use memchr as the compiler can use an optimized scan rather than a for loop.
+                const auto Piviot = (const uint8_t *)std::memchr(Base + Anchor, Anchorbyte, size_t(Last - Base) + 1);
+
+                // No more bytes in the range.
+                if (!Piviot) [[unlikely]]
+                    return nullptr;
+
+                // Rare case that something is found.
+                if (Matcher.Compare(Piviot - Anchor)) [[unlikely]]
+                    return Piviot - Anchor;
+
+                Base = Piviot - Anchor + 1;
+            }
 
-            Base = Piviot + 1;
-            Count = Range.second - std::uintptr_t(Base) - Pattern.size();
+            return nullptr;
         }
-    }
 
-    // Scan until the end of the range and return all results.
-    [[nodiscard]] inline std::vector<std::uintptr_t> Findpatterns(const Range_t Range, Patternmask_view Pattern, Patternmask_view Mask)
-    {
-        std::vector<std::uintptr_t> Results;
-        Range_t Localrange = Range;
-        size_t Lastresult = 0;
+        // Tests 32 positions per step against both anchors, then verifies candidates with masked vector compares.
+        TARGET_ATTR("avx2") inline bool Compare_AVX2(const Matcher_t &Matcher, const uint8_t *Address, const uint8_t *End)
+        {
+            // Near the end of the range a full vector could touch unmapped memory.
+            if (!Matcher.Vectorsize || size_t(End - Address) < Matcher.Vectorsize) return Matcher.Compare(Address);
+
+            for (size_t i = 0; i < Matcher.Vectorsize; i += 32)
+            {
+                const auto Memory = _mm256_loadu_si256((const __m256i *)(Address + i));
+                const auto Pattern = _mm256_load_si256((const __m256i *)(Matcher.Patternbytes + i));
+                const auto Mask = _mm256_load_si256((const __m256i *)(Matcher.Maskbytes + i));
+
+                if (!_mm256_testz_si256(_mm256_xor_si256(Memory, Pattern), Mask)) return false;
+            }
 
-        while (true)
+            return true;
+        }
+        TARGET_ATTR("avx2") inline const uint8_t *Find_AVX2(const Matcher_t &Matcher, const uint8_t *Begin, const uint8_t *End)
         {
-            Lastresult = Findpattern(Localrange, Pattern, Mask);
+            if (size_t(End - Begin) < Matcher.Pattern.size()) return nullptr;
+            if (!Matcher.Mask[Matcher.Firstanchor]) return Begin;
 
-            if (Lastresult == 0)
-                break;
+            const auto Positions = size_t(End - Begin) - Matcher.Pattern.size() + 1;
+            const auto First = _mm256_set1_epi8(char(Matcher.Pattern[Matcher.Firstanchor]));
+            const auto Second = _mm256_set1_epi8(char(Matcher.Pattern[Matcher.Secondanchor]));
 
-            Localrange.first = Lastresult + 1;
-            Results.push_back(Lastresult);
+            size_t Offset = 0;
+            for (; Offset + 32 <= Positions; Offset += 32)
+            {
+                const auto A = _mm256_loadu_si256((const __m256i *)(Begin + Offset + Matcher.Firstanchor));
+                const auto B = _mm256_loadu_si256((const __m256i *)(Begin + Offset + Matcher.Secondanchor));
+                auto Candidates = uint32_t(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(A, First), _mm256_cmpeq_epi8(B, Second))));
+
+                while (Candidates) [[unlikely]]
+                {
+                    const auto Address = Begin + Offset + std::countr_zero(Candidates);
+                    if (Compare_AVX2(Matcher, Address, End)) return Address;
+                    Candidates &= Candidates - 1;
+                }
+            }
+
+            return Find_scalar(Matcher, Begin + Offset, End);
+        }
+
+        [[nodiscard]] inline const uint8_t *Find(const Matcher_t &Matcher, const uint8_t *Begin, const uint8_t *End)
+        {
+            if (Cpufeatures::hasAVX2()) return Find_AVX2(Matcher, Begin, End);
+            return Find_scalar(Matcher, Begin, End);
         }
+        [[nodiscard]] inline std::vector<std::uintptr_t> Findall(const Matcher_t &Matcher, const Range_t &Range)
+        {
+            std::vector<std::uintptr_t> Results;
+            const auto End = (const uint8_t *)Range.second;
+            auto Begin = (const uint8_t *)Range.first;
 
-        return Results;
+            while (const auto Result = Find(Matcher, Begin, End))
+            {
+                Results.push_back(std::uintptr_t(Result));
+                Begin = Result + 1;
+            }
+
+            return Results;
+        }
+    }
+
+    // Find a single pattern in a range.
+    [[nodiscard]] inline std::uintptr_t Findpattern(const Range_t &Range, Patternmask_view Pattern, Patternmask_view Mask)
+    {
+        assert(Range.second != 0);
+        assert(Range.first != 0);
+
+        const Internal::Matcher_t Matcher(Pattern, Mask);
+        return std::uintptr_t(Internal::Find(Matcher, (const uint8_t *)Range.first, (const uint8_t *)Range.second));
+    }
+
+    // Scan until the end of the range and return all results.
+    [[nodiscard]] inline std::vector<std::uintptr_t> Findpatterns(const Range_t Range, Patternmask_view Pattern, Patternmask_view Mask)
+    {
+        assert(Range.second != 0);
+        assert(Range.first != 0);
+
+        const Internal::Matcher_t Matcher(Pattern, Mask);
+        return Internal::Findall(Matcher, Range);
     }
 
     // Calculate the hosts default ranges, once per compilation-module on some compilers.
@@ -131,6 +267,52 @@ namespace Patternscan
 
         return { Textsegment, Datasegment };
     }
+    // Committed and readable memory of the current process, adjacent regions are merged.
+    [[nodiscard]] inline std::vector<Range_t> Readableregions()
+    {
+        std::vector<Range_t> Regions;
+        const auto Append = [&](std::uintptr_t Start, std::uintptr_t End)
+        {
+            if (!Regions.empty() && Regions.back().second == Start) Regions.back().second = End;
+            else Regions.emplace_back(Start, End);
+        };
+
+        #if defined(_WIN32)
+        MEMORY_BASIC_INFORMATION Pageinformation{};
+        std::uintptr_t Address{};
+
+        while (VirtualQuery((LPCVOID)Address, &Pageinformation, sizeof(MEMORY_BASIC_INFORMATION)))
+        {
+            const auto Start = std::uintptr_t(Pageinformation.BaseAddress);
+            const auto End = Start + Pageinformation.RegionSize;
+
+            if (Pageinformation.State == MEM_COMMIT && !(Pageinformation.Protect & (PAGE_NOACCESS | PAGE_GUARD)))
+                Append(Start, End);
+
+            if (End <= Address) break;
+            Address = End;
+        }
+        #else
+        const auto Filehandle = std::fopen("/proc/self/maps", "r");
+        if (!Filehandle) return Regions;
+
+        char Line[512];
+        while (std::fgets(Line, sizeof(Line), Filehandle))
+        {
+            unsigned long long Start{}, End{};
+            char Permissions[5]{};
+            if (3 != std::sscanf(Line, "%llx-%llx %4s", &Start, &End, Permissions)) continue;
+
+            // The vvar page faults on some kernels even when mapped readable.
+            if (Permissions[0] != 'r' || std::strstr(Line, "[vvar")) continue;
+            Append(std::uintptr_t(Start), std::uintptr_t(End));
+        }
+
+        std::fclose(Filehandle);
+        #endif
+
+        return Regions;
+    }
     [[nodiscard]] inline Range_t Virtualrange()
     {
         auto Currentpage = Defaultranges().second.second;
@@ -144,7 +326,12 @@ namespace Patternscan
             Currentpage = (size_t)Pageinformation.BaseAddress + Pageinformation.RegionSize;
         }
         #else
-        static_assert(false, "Not implemented");
+        for (const auto &Region : Readableregions())
+        {
+            if (Region.second <= Currentpage) continue;
+            if (Region.first > Currentpage) break;
+            Currentpage = Region.second;
+        }
         #endif
 
         Range.second = Currentpage;
@@ -174,24 +361,240 @@ namespace Patternscan
         return Result;
     }
 
+    // IDA style patterns to pattern and mask, wildcards get a zero mask.
+    [[nodiscard]] inline std::pair<Patternmask_t, Patternmask_t> from_IDA(std::string_view IDAPattern)
+    {
+        auto Pattern = from_string(IDAPattern);
+        Patternmask_t Mask; Mask.reserve(Pattern.size());
+
+        // Same tokenization as from_string, a byte per wildcard or hex-pair.
+        uint32_t Count{ 0 };
+        for (const auto &Item : IDAPattern)
+        {
+            if (Item == ' ') { Count = 0; continue; }
+            if (Item == '?') Mask.push_back('\x00');
+            else if (!(Count++ & 1)) Mask.push_back('\x01');
+        }
+
+        return { std::move(Pattern), std::move(Mask) };
+    }
+
+    // Parsed at compile-time, "48 8B ? ? 89" with single '?' wildcards; anything else fails to compile.
+    template <size_t N> struct Patternliteral_t
+    {
+        // Every byte needs two characters, all but the last a separator.
+        uint8_t Pattern[N / 2]{}, Mask[N / 2]{};
+        size_t Length{}, Firstanchor{}, Secondanchor{};
+
+        consteval Patternliteral_t(const char (&Readable)[N])
+        {
+            const auto Nibble = [](char Item) -> uint8_t
+            {
+                if (Item >= '0' && Item <= '9') return Item - '0';
+                if (Item >= 'a' && Item <= 'f') return Item - 'a' + 10;
+                if (Item >= 'A' && Item <= 'F') return Item - 'A' + 10;
+                throw "Invalid hex-digit in pattern.";
+            };
+
+            for (size_t i = 0; i < N - 1;)
+            {
+                if (Readable[i] == ' ') { ++i; continue; }
+
+                if (Readable[i] == '?') { Mask[Length] = 0; Pattern[Length++] = 0; i += 1; }
+                else if (i + 1 < N - 1) { Mask[Length] = 1; Pattern[Length++] = Nibble(Readable[i]) << 4 | Nibble(Readable[i + 1]); i += 2; }
+                else throw "Incomplete byte in pattern.";
+
+                if (i < N - 1 && Readable[i] != ' ') throw "Bytes need to be separated by spaces.";
+            }
+
+            if (Length == 0) throw "Empty pattern.";
+            std::tie(Firstanchor, Secondanchor) = Internal::Selectanchors(Patternview(), Maskview());
+        }
+
+        [[nodiscard]] constexpr Patternmask_view Patternview() const { return { Pattern, Length }; }
+        [[nodiscard]] constexpr Patternmask_view Maskview() const { return { Mask, Length }; }
+        [[nodiscard]] Internal::Matcher_t Matcher() const { return { Patternview(), Maskview(), { Firstanchor, Secondanchor } }; }
+    };
+
     // IDA style pattern scanning.
     [[nodiscard]] inline std::vector<std::uintptr_t> Findpatterns(const Range_t Range, std::string IDAPattern)
     {
-        const auto Pattern = from_string(IDAPattern);
+        const auto [Pattern, Mask] = from_IDA(std::move(IDAPattern));
+        return Findpatterns(Range, Pattern, Mask);
+    }
+    [[nodiscard]] inline std::uintptr_t Findpattern(const Range_t Range, std::string IDAPattern)
+    {
+        const auto [Pattern, Mask] = from_IDA(std::move(IDAPattern));
+        return Findpattern(Range, Pattern, Mask);
+    }
 
-        while (IDAPattern.find(" 0 ") != std::string::npos) IDAPattern.replace(IDAPattern.find(" 0 "), 4, " 00 ");
-        while (IDAPattern.find("00") != std::string::npos) IDAPattern.replace(IDAPattern.find("00"), 2, "01");
+    // Compile-time patterns, no parsing or allocation per call.
+    template <size_t N> [[nodiscard]] std::vector<std::uintptr_t> Findpatterns(const Range_t Range, const Patternliteral_t<N> &Literal)
+    {
+        assert(Range.second != 0);
+        assert(Range.first != 0);
 
-        return Findpatterns(Range, Pattern, from_string(IDAPattern));
+        return Internal::Findall(Literal.Matcher(), Range);
     }
-    [[nodiscard]] inline std::uintptr_t Findpattern(const Range_t Range, std::string IDAPattern)
+    template <size_t N> [[nodiscard]] std::uintptr_t Findpattern(const Range_t Range, const Patternliteral_t<N> &Literal)
+    {
+        assert(Range.second != 0);
+        assert(Range.first != 0);
+
+        return std::uintptr_t(Internal::Find(Literal.Matcher(), (const uint8_t *)Range.first, (const uint8_t *)Range.second));
+    }
+
+    // Many patterns in a single pass, so the cost depends on the range rather than range * patterns.
+    // Candidates are filtered on each patterns rarest byte-pair (or byte), then on its first 8 bytes.
+    struct Patternset_t
     {
-        const auto Pattern = from_string(IDAPattern);
+        struct Entry_t { Patternmask_t Pattern, Mask; };
+        struct Candidate_t { uint64_t Prefix, Prefixmask; uint32_t Index, Anchor; };
+        std::vector<Entry_t> Entries;
+
+        std::unordered_map<uint16_t, std::vector<Candidate_t>> Pairbuckets;
+        std::array<std::vector<Candidate_t>, 256> Bytebuckets;
+        std::array<uint64_t, 65536 / 64> Pairfilter{};
+        std::array<uint64_t, 256 / 64> Bytefilter{};
+        bool hasBytes{};
+
+        // Patterns need at least one non-wildcard byte, returns the index for the results.
+        size_t Add(Patternmask_view Pattern, Patternmask_view Mask)
+        {
+            assert(Pattern.size() == Mask.size());
+            assert(Pattern.size() != 0);
+
+            const auto Index = uint32_t(Entries.size());
+            size_t Pair = SIZE_MAX, Single = SIZE_MAX;
+            Entries.push_back({ Patternmask_t(Pattern), Patternmask_t(Mask) });
+
+            for (size_t i = 0; i < Mask.size(); ++i)
+            {
+                if (!Mask[i]) continue;
+
+                if (Single == SIZE_MAX || Internal::Byterank[Pattern[i]] < Internal::Byterank[Pattern[Single]]) Single = i;
+                if (i + 1 < Mask.size() && Mask[i + 1])
+                {
+                    const auto Rank = Internal::Byterank[Pattern[i]] + Internal::Byterank[Pattern[i + 1]];
+                    if (Pair == SIZE_MAX || Rank < Internal::Byterank[Pattern[Pair]] + Internal::Byterank[Pattern[Pair + 1]]) Pair = i;
+                }
+            }
+
+            // Little-endian so that it can be compared with an unaligned load.
+            Candidate_t Candidate{ 0, 0, Index, 0 };
+            for (size_t i = 0; i < std::min(Pattern.size(), sizeof(uint64_t)); ++i)
+            {
+                if (!Mask[i]) continue;
+                Candidate.Prefix |= uint64_t(Pattern[i]) << (8 * i);
+                Candidate.Prefixmask |= uint64_t(0xFF) << (8 * i);
+            }
+
+            if (Pair != SIZE_MAX)
+            {
+                const uint16_t Key = Pattern[Pair] | (Pattern[Pair + 1] << 8);
+                Pairfilter[Key / 64] |= uint64_t(1) << (Key % 64);
+                Candidate.Anchor = uint32_t(Pair);
+                Pairbuckets[Key].push_back(Candidate);
+            }
+            else if (Single != SIZE_MAX)
+            {
+                const uint8_t Key = Pattern[Single];
+                Bytefilter[Key / 64] |= uint64_t(1) << (Key % 64);
+                Candidate.Anchor = uint32_t(Single);
+                Bytebuckets[Key].push_back(Candidate);
+                hasBytes = true;
+            }
+            else assert(false); // All wildcards, never matches.
+
+            return Index;
+        }
+        size_t Add(std::string IDAPattern)
+        {
+            const auto [Pattern, Mask] = from_IDA(std::move(IDAPattern));
+            return Add(Pattern, Mask);
+        }
+        template <size_t N> size_t Add(const Patternliteral_t<N> &Literal)
+        {
+            return Add(Literal.Patternview(), Literal.Maskview());
+        }
+
+        // Results are indexed as the patterns were added, each in ascending order.
+        [[nodiscard]] std::vector<std::vector<std::uintptr_t>> Scan(const Range_t &Range) const
+        {
+            assert(Range.second != 0);
+            assert(Range.first != 0);
+
+            std::vector<std::vector<std::uintptr_t>> Results(Entries.size());
+            const auto Begin = (const uint8_t *)Range.first;
+            const auto End = (const uint8_t *)Range.second;
+            if (End <= Begin) return Results;
+
+            // A handful of patterns is faster as separate vectorized scans.
+            if (Entries.size() < 16 && Cpufeatures::hasAVX2())
+            {
+                for (size_t i = 0; i < Entries.size(); ++i)
+                {
+                    const Internal::Matcher_t Matcher(Entries[i].Pattern, Entries[i].Mask);
+                    if (!Matcher.Mask[Matcher.Firstanchor]) continue;
 
-        while (IDAPattern.find(" 0 ") != std::string::npos) IDAPattern.replace(IDAPattern.find(" 0 "), 4, " 00 ");
-        while (IDAPattern.find("00") != std::string::npos) IDAPattern.replace(IDAPattern.find("00"), 2, "01");
+                    for (auto Address = Internal::Find(Matcher, Begin, End); Address; Address = Internal::Find(Matcher, Address + 1, End))
+                        Results[i].push_back(std::uintptr_t(Address));
+                }
+
+                return Results;
+            }
+
+            const auto Check = [&](const std::vector<Candidate_t> &Bucket, const uint8_t *Address)
+            {
+                for (const auto &Candidate : Bucket)
+                {
+                    const auto &Entry = Entries[Candidate.Index];
+                    if (size_t(Address - Begin) < Candidate.Anchor) continue;
+
+                    const auto Start = Address - Candidate.Anchor;
+                    const auto Remaining = size_t(End - Start);
+                    if (Remaining < Entry.Pattern.size()) continue;
+
+                    if (Remaining >= sizeof(uint64_t))
+                    {
+                        uint64_t Prefix;
+                        std::memcpy(&Prefix, Start, sizeof(Prefix));
+                        if ((Prefix & Candidate.Prefixmask) != Candidate.Prefix) [[likely]] continue;
+                    }
+
+                    bool isMatch = true;
+                    for (size_t i = 0; i < Entry.Pattern.size() && isMatch; ++i)
+                        isMatch = !Entry.Mask[i] || Start[i] == Entry.Pattern[i];
+
+                    if (isMatch) Results[Candidate.Index].push_back(std::uintptr_t(Start));
+                }
+            };
+
+            if (hasBytes)
+            {
+                for (auto Address = Begin; Address < End; ++Address)
+                {
+                    if ((Bytefilter[*Address / 64] >> (*Address % 64)) & 1) [[unlikely]]
+                        Check(Bytebuckets[*Address], Address);
+                }
+            }
 
-        return Findpattern(Range, Pattern, from_string(IDAPattern));
+            // Each pattern has a single anchor, so results stay in ascending order.
+            for (auto Address = Begin; Address + 1 < End; ++Address)
+            {
+                const uint16_t Key = Address[0] | (Address[1] << 8);
+                if ((Pairfilter[Key / 64] >> (Key % 64)) & 1) [[unlikely]]
+                    Check(Pairbuckets.find(Key)->second, Address);
+            }
+
+            return Results;
+        }
+    };
+    [[nodiscard]] inline std::vector<std::vector<std::uintptr_t>> Findpatterns(const Range_t Range, std::span<const std::string> IDAPatterns)
+    {
+        Patternset_t Patternset;
+        for (const auto &Pattern : IDAPatterns) Patternset.Add(Pattern);
+        return Patternset.Scan(Range);
     }
 
     // Find strings in memory - helper.
@@ -200,4 +603,115 @@ namespace Patternscan
         const Patternmask_t Hexstring{ String.begin(), String.end() };
         return Findpatterns(Range, Hexstring, Hexstring);
     };
+
+    // Splits ranges into cache-sized chunks that are scanned on all cores, results are in ascending order.
+    namespace Parallel
+    {
+        namespace Internal
+        {
+            constexpr size_t Chunksize = 1024 * 1024;
+
+            // Chunks overlap by the pattern-length so that only matches starting in a chunk are reported by it.
+            template <typename Scanner> auto Scanchunks(std::span<const Range_t> Ranges, size_t Patternlength, Scanner &&Scan, size_t Threadcount)
+            {
+                std::vector<Range_t> Chunks;
+
+                for (const auto &[First, Last] : Ranges)
+                {
+                    for (auto Offset = First; Offset < Last; Offset += Chunksize)
+                    {
+                        // Narrower ranges can't contain the pattern anyway.
+                        const auto End = std::min(Last, Offset + Chunksize + Patternlength - 1);
+                        Chunks.emplace_back(Offset, End);
+
+                        if (End == Last) break;
+                    }
+                }
+
+                std::vector<decltype(Scan(Chunks[0]))> Results(Chunks.size());
+                std::atomic<size_t> Next{};
+
+                const auto Worker = [&]()
+                {
+                    for (auto Chunk = Next++; Chunk < Chunks.size(); Chunk = Next++)
+                        Results[Chunk] = Scan(Chunks[Chunk]);
+                };
+
+                // The calling thread does its share.
+                Threadcount = std::clamp(Threadcount, size_t(1), std::max(size_t(1), Chunks.size()));
+                std::vector<std::thread> Threads;
+                Threads.reserve(Threadcount - 1);
+
+                for (size_t i = 1; i < Threadcount; ++i) Threads.emplace_back(Worker);
+                Worker();
+                for (auto &Thread : Threads) Thread.join();
+
+                return Results;
+            }
+        }
+
+        [[nodiscard]] inline std::vector<std::uintptr_t> Findpatterns(std::span<const Range_t> Ranges, Patternmask_view Pattern, Patternmask_view Mask,
+                                                                      size_t Threadcount = std::thread::hardware_concurrency())
+        {
+            const Patternscan::Internal::Matcher_t Matcher(Pattern, Mask);
+            const auto Chunks = Internal::Scanchunks(Ranges, Pattern.size(), [&](const Range_t &Chunk)
+            {
+                std::vector<std::uintptr_t> Results;
+                const auto End = (const uint8_t *)Chunk.second;
+
+                for (auto Address = Patternscan::Internal::Find(Matcher, (const uint8_t *)Chunk.first, End); Address;
+                     Address = Patternscan::Internal::Find(Matcher, Address + 1, End))
+                    Results.push_back(std::uintptr_t(Address));
+
+                return Results;
+            }, Threadcount);
+
+            std::vector<std::uintptr_t> Results;
+            for (const auto &Chunk : Chunks) Results.insert(Results.end(), Chunk.begin(), Chunk.end());
+            return Results;
+        }
+        [[nodiscard]] inline std::vector<std::uintptr_t> Findpatterns(const Range_t Range, Patternmask_view Pattern, Patternmask_view Mask,
+                                                                      size_t Threadcount = std::thread::hardware_concurrency())
+        {
+            return Findpatterns(std::span<const Range_t>(&Range, 1), Pattern, Mask, Threadcount);
+        }
+        [[nodiscard]] inline std::vector<std::uintptr_t> Findpatterns(const Range_t Range, std::string IDAPattern)
+        {
+            const auto [Pattern, Mask] = from_IDA(std::move(IDAPattern));
+            return Findpatterns(Range, Pattern, Mask);
+        }
+        template <size_t N> [[nodiscard]] std::vector<std::uintptr_t> Findpatterns(const Range_t Range, const Patternliteral_t<N> &Literal)
+        {
+            return Findpatterns(Range, Literal.Patternview(), Literal.Maskview());
+        }
+        [[nodiscard]] inline std::vector<std::uintptr_t> Findstrings(const Range_t Range, const std::string_view String)
+        {
+            const Patternmask_t Hexstring{ String.begin(), String.end() };
+            return Findpatterns(Range, Hexstring, Hexstring);
+        }
+
+        // Results are indexed as the patterns were added.
+        [[nodiscard]] inline std::vector<std::vector<std::uintptr_t>> Scan(const Patternset_t &Patternset, std::span<const Range_t> Ranges,
+                                                                            size_t Threadcount = std::thread::hardware_concurrency())
+        {
+            size_t Longest{};
+            for (const auto &Entry : Patternset.Entries) Longest = std::max(Longest, Entry.Pattern.size());
+
+            const auto Chunks = Internal::Scanchunks(Ranges, Longest, [&](const Range_t &Chunk)
+            {
+                auto Results = Patternset.Scan(Chunk);
+
+                // Shorter patterns may match in the overlap, the next chunk reports those.
+                const auto Limit = std::min(Chunk.second, Chunk.first + Internal::Chunksize);
+                for (auto &Result : Results) std::erase_if(Result, [&](const auto &Address) { return Address >= Limit; });
+                return Results;
+            }, Threadcount);
+
+            std::vector<std::vector<std::uintptr_t>> Results(Patternset.Entries.size());
+            for (const auto &Chunk : Chunks)
+                for (size_t i = 0; i < Chunk.size(); ++i)
+                    Results[i].insert(Results[i].end(), Chunk[i].begin(), Chunk[i].end());
+            return Results;
+        }
+    }
 }
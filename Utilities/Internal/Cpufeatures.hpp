@@ -0,0 +1,101 @@
+/*
+    Initial author: Convery (tcn@ayria.se)
+    Started: 2020-11-02
+    License: MIT
+
+    Runtime detection of instruction-set extensions.
+    if (Cpufeatures::hasAVX2()) Kernel_AVX2(...); else Kernel_scalar(...);
+*/
+
+#pragma once
+#include <cstdint>
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+// GCC / Clang need to be told that a function may use extensions beyond the -march baseline.
+#if defined(_MSC_VER)
+#define TARGET_ATTR(x)
+#else
+#define TARGET_ATTR(x) __attribute__((target(x)))
+#endif
+
+namespace Cpufeatures
+{
+    struct Features_t
+    {
+        bool SSSE3, SSE41, SSE42, PCLMUL, AVX, AVX2, BMI1, BMI2;
+    };
+
+    namespace Internal
+    {
+        inline void CPUID(uint32_t Leaf, uint32_t Subleaf, uint32_t Registers[4])
+        {
+            #if defined(_MSC_VER)
+            __cpuidex((int *)Registers, int(Leaf), int(Subleaf));
+            #else
+            __cpuid_count(Leaf, Subleaf, Registers[0], Registers[1], Registers[2], Registers[3]);
+            #endif
+        }
+        inline uint64_t XGETBV(uint32_t Index)
+        {
+            #if defined(_MSC_VER)
+            return _xgetbv(Index);
+            #else
+            uint32_t EAX, EDX;
+            __asm__ volatile("xgetbv" : "=a"(EAX), "=d"(EDX) : "c"(Index));
+            return (uint64_t(EDX) << 32) | EAX;
+            #endif
+        }
+
+        inline Features_t Detect()
+        {
+            Features_t Result{};
+            uint32_t Registers[4]{};
+
+            CPUID(0, 0, Registers);
+            const auto Maxleaf = Registers[0];
+            if (Maxleaf < 1) return Result;
+
+            CPUID(1, 0, Registers);
+            Result.SSSE3  = Registers[2] & (1U << 9);
+            Result.SSE41  = Registers[2] & (1U << 19);
+            Result.SSE42  = Registers[2] & (1U << 20);
+            Result.PCLMUL = Registers[2] & (1U << 1);
+
+            // The OS needs to save the YMM registers on context-switches for AVX to be usable.
+            const bool OSXSAVE = Registers[2] & (1U << 27);
+            const bool hasAVX = Registers[2] & (1U << 28);
+            Result.AVX = OSXSAVE && hasAVX && (XGETBV(0) & 0x6) == 0x6;
+
+            if (Maxleaf >= 7)
+            {
+                CPUID(7, 0, Registers);
+                Result.AVX2 = Result.AVX && (Registers[1] & (1U << 5));
+                Result.BMI1 = Registers[1] & (1U << 3);
+                Result.BMI2 = Registers[1] & (1U << 8);
+            }
+
+            return Result;
+        }
+    }
+
+    // Evaluated once per process.
+    [[nodiscard]] inline const Features_t &Get()
+    {
+        static const Features_t Features = Internal::Detect();
+        return Features;
+    }
+
+    [[nodiscard]] inline bool hasSSSE3() { return Get().SSSE3; }
+    [[nodiscard]] inline bool hasSSE41() { return Get().SSE41; }
+    [[nodiscard]] inline bool hasSSE42() { return Get().SSE42; }
+    [[nodiscard]] inline bool hasPCLMUL() { return Get().PCLMUL; }
+    [[nodiscard]] inline bool hasAVX() { return Get().AVX; }
+    [[nodiscard]] inline bool hasAVX2() { return Get().AVX2; }
+    [[nodiscard]] inline bool hasBMI2() { return Get().BMI2; }
+}
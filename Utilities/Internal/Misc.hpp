@@ -80,13 +80,13 @@ struct Range
 
 #pragma endregion
 
-// Safer nlohmann parsing.
+// Safer nlohmann parsing, the input does not need to be null-terminated (e.g. FS::Mappedfile).
 #if defined HAS_NLOHMANN
 inline nlohmann::json ParseJSON(std::string_view Input)
 {
     try
     {
-        return nlohmann::json::parse(Input.data(), nullptr, true, true);
+        return nlohmann::json::parse(Input.begin(), Input.end(), nullptr, true, true);
     }
     catch (...) {}
 
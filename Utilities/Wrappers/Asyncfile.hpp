@@ -0,0 +1,342 @@
+/*
+    Initial author: Convery (tcn@ayria.se)
+    Started: 2020-11-16
+    License: MIT
+
+    File-IO on a dedicated thread so that callers never wait for the disk.
+    Requests are processed in batches, one per wake-up, and coalesced per path:
+    queued writes to a file collapse into the latest, queued reads share a read,
+    and a read queued behind a write is answered from the write's buffer.
+    Writes replace the file atomically, see FS::Writefileatomic.
+
+    FS::Async::Readfile("./Ayria/Clientinfo.json", [](Blob &&Content) { ... });
+    FS::Async::Writebehind(L"./Ayria/Relations.json", S2B(Content));
+    FS::Async::Writebehind(L"./Ayria/Relations.json", [] { return Serialize(); }, 2s);
+*/
+
+#pragma once
+#include <Stdinclude.hpp>
+#include "Filesystem.hpp"
+#include <future>
+#include <deque>
+
+namespace FS::Async
+{
+    using namespace std::chrono_literals;
+    using Readcallback_t = std::function<void(Blob &&Content)>;
+    using Writecallback_t = std::function<void(bool Success)>;
+    using Serializer_t = std::function<Blob()>;
+
+    namespace Internal
+    {
+        struct Request_t
+        {
+            std::filesystem::path Path{};
+            Blob Buffer{};
+            bool isWrite{};
+
+            // Produces the buffer on the IO thread if set.
+            Serializer_t Serializer{};
+
+            std::vector<Readcallback_t> Readers{};
+            std::vector<Writecallback_t> Writers{};
+        };
+
+        struct Pathhash_t { size_t operator()(const std::filesystem::path &Path) const { return std::filesystem::hash_value(Path); } };
+
+        struct Service_t
+        {
+            using Clock_t = std::chrono::steady_clock;
+
+            // Write-behind buffers wait here until their deadline.
+            struct Delayed_t { Blob Buffer; Serializer_t Serializer; Clock_t::time_point Deadline; };
+            std::unordered_map<std::filesystem::path, Delayed_t, Pathhash_t> Delayed;
+            std::deque<Request_t> Pending;
+            std::condition_variable Signal, Idle;
+            std::mutex Lock;
+            bool isBusy{};
+
+            // Paths in the batch being processed.
+            std::vector<std::filesystem::path> Inflight;
+            std::thread::id Workerid;
+
+            #if defined(_WIN32)
+            HANDLE Workerthread{};
+            #endif
+
+            // When the process exits on Windows, other threads are terminated before the atexit handlers run.
+            // Elsewhere they keep running until the handlers are done, so the worker can finish the queue.
+            [[nodiscard]] bool isWorkergone() const
+            {
+                #if defined(_WIN32)
+                    return Workerthread && WAIT_OBJECT_0 == WaitForSingleObject(Workerthread, 0);
+                #else
+                    return false;
+                #endif
+            }
+
+            // E.g. a file in a directory, or the file itself.
+            [[nodiscard]] static bool isWithin(const std::filesystem::path &Scope, const std::filesystem::path &Path)
+            {
+                const auto Relative = Path.lexically_relative(Scope);
+                return !Relative.empty() && *Relative.begin() != "..";
+            }
+
+            // Only the last request for a path can absorb new ones, else the order would change.
+            Request_t *Findlast(const std::filesystem::path &Path)
+            {
+                for (auto Item = Pending.rbegin(); Item != Pending.rend(); ++Item)
+                    if (Item->Path == Path) return &*Item;
+                return nullptr;
+            }
+
+            // Lock held, moves delayed writes into the queue.
+            void Promote(const std::filesystem::path &Path)
+            {
+                const auto Entry = Delayed.find(Path);
+                if (Entry == Delayed.end()) return;
+
+                Queue({ Path, std::move(Entry->second.Buffer), true, std::move(Entry->second.Serializer) });
+                Delayed.erase(Entry);
+            }
+            void Promote(Clock_t::time_point Deadline)
+            {
+                for (auto Entry = Delayed.begin(); Entry != Delayed.end();)
+                {
+                    if (Entry->second.Deadline > Deadline) { ++Entry; continue; }
+
+                    Queue({ Entry->first, std::move(Entry->second.Buffer), true, std::move(Entry->second.Serializer) });
+                    Entry = Delayed.erase(Entry);
+                }
+            }
+
+            // Lock held, returns false if the request was merged into a queued one.
+            bool Queue(Request_t &&Request)
+            {
+                if (const auto Last = Findlast(Request.Path); Last && Last->isWrite == Request.isWrite)
+                {
+                    if (Request.isWrite)
+                    {
+                        Last->Buffer = std::move(Request.Buffer);
+                        Last->Serializer = std::move(Request.Serializer);
+                    }
+                    for (auto &Item : Request.Readers) Last->Readers.push_back(std::move(Item));
+                    for (auto &Item : Request.Writers) Last->Writers.push_back(std::move(Item));
+                    return false;
+                }
+
+                Pending.push_back(std::move(Request));
+                return true;
+            }
+
+            void Enqueue(Request_t &&Request)
+            {
+                std::unique_lock Guard(Lock);
+                Promote(Request.Path);
+
+                // Reads behind a queued write are answered from its buffer, outside the lock as callbacks may queue more.
+                if (const auto Last = Findlast(Request.Path); Last && Last->isWrite && !Last->Serializer && !Request.isWrite)
+                {
+                    const auto Written = Last->Buffer;
+                    Guard.unlock();
+
+                    for (const auto &Callback : Request.Readers) Callback(Blob(Written));
+                    return;
+                }
+
+                if (Queue(std::move(Request))) Signal.notify_one();
+            }
+            void Enqueue(std::filesystem::path &&Path, Blob &&Buffer, Serializer_t &&Serializer, std::chrono::milliseconds Delay)
+            {
+                {
+                    std::scoped_lock Guard(Lock);
+
+                    // The first write sets the deadline, so a steady stream of updates still reaches the disk.
+                    const auto [Entry, isNew] = Delayed.try_emplace(std::move(Path), Blob(), nullptr, Clock_t::now() + Delay);
+                    Entry->second.Buffer = std::move(Buffer);
+                    Entry->second.Serializer = std::move(Serializer);
+                    if (!isNew) return;
+                }
+                Signal.notify_one();
+            }
+
+            static void Process(std::deque<Request_t> &Batch)
+            {
+                for (auto &Request : Batch)
+                {
+                    if (Request.isWrite)
+                    {
+                        if (Request.Serializer) Request.Buffer = Request.Serializer();
+                        const auto Result = FS::Writefileatomic(Request.Path, Request.Buffer);
+                        for (const auto &Callback : Request.Writers) Callback(Result);
+                    }
+                    else
+                    {
+                        auto Content = FS::Readfile(Request.Path.native());
+                        for (size_t i = 0; i < Request.Readers.size(); ++i)
+                            Request.Readers[i](i + 1 == Request.Readers.size() ? std::move(Content) : Blob(Content));
+                    }
+                }
+            }
+
+            [[noreturn]] void Workerloop()
+            {
+                while (true)
+                {
+                    std::deque<Request_t> Batch;
+                    {
+                        std::unique_lock Guard(Lock);
+
+                        while (Pending.empty())
+                        {
+                            if (Delayed.empty()) { Signal.wait(Guard); continue; }
+
+                            auto Deadline = Clock_t::time_point::max();
+                            for (const auto &[_, Entry] : Delayed) Deadline = std::min(Deadline, Entry.Deadline);
+
+                            Signal.wait_until(Guard, Deadline);
+                            Promote(Clock_t::now());
+                        }
+
+                        // Delayed writes that came due while the queue was busy.
+                        Promote(Clock_t::now());
+                        Batch.swap(Pending);
+                        isBusy = true;
+
+                        for (const auto &Request : Batch) Inflight.push_back(Request.Path);
+                    }
+
+                    Process(Batch);
+
+                    {
+                        std::scoped_lock Guard(Lock);
+                        Inflight.clear();
+                        isBusy = false;
+                    }
+                    Idle.notify_all();
+                }
+            }
+
+            // Blocks until everything queued so far is on disk. At process-exit the worker may already
+            // be gone, in which case whatever remains is processed on the calling thread instead.
+            void Flush()
+            {
+                std::deque<Request_t> Batch;
+                {
+                    std::unique_lock Guard(Lock);
+                    Promote(Clock_t::time_point::max());
+                    Signal.notify_one();
+
+                    // Never alongside the worker, both would write the same files.
+                    const auto isDone = [this] { return Pending.empty() && !isBusy; };
+                    if (std::this_thread::get_id() != Workerid)
+                    {
+                        while (!Idle.wait_for(Guard, 1s, isDone))
+                            if (isWorkergone()) break;
+
+                        if (isDone()) return;
+                    }
+
+                    Batch.swap(Pending);
+                }
+
+                Process(Batch);
+            }
+
+            // Blocks until the requests for files within the scope have completed, others are left queued.
+            void Flush(const std::filesystem::path &Scope)
+            {
+                // Would wait for itself.
+                assert(std::this_thread::get_id() != Workerid);
+                std::unique_lock Guard(Lock);
+
+                for (auto Entry = Delayed.begin(); Entry != Delayed.end();)
+                {
+                    if (!isWithin(Scope, Entry->first)) { ++Entry; continue; }
+
+                    Queue({ Entry->first, std::move(Entry->second.Buffer), true, std::move(Entry->second.Serializer) });
+                    Entry = Delayed.erase(Entry);
+                }
+                Signal.notify_one();
+
+                Idle.wait(Guard, [&]
+                {
+                    return std::none_of(Pending.begin(), Pending.end(), [&](const auto &Request) { return isWithin(Scope, Request.Path); }) &&
+                           std::none_of(Inflight.begin(), Inflight.end(), [&](const auto &Path) { return isWithin(Scope, Path); });
+                });
+            }
+
+            Service_t()
+            {
+                std::thread Worker([this] { Workerloop(); });
+                Workerid = Worker.get_id();
+
+                #if defined(_WIN32)
+                    DuplicateHandle(GetCurrentProcess(), Worker.native_handle(), GetCurrentProcess(), &Workerthread, SYNCHRONIZE, FALSE, 0);
+                #endif
+
+                Worker.detach();
+                std::atexit([] { getService()->Flush(); });
+            }
+
+            // Never destroyed as the worker outlives static destruction.
+            static Service_t *getService()
+            {
+                static const auto Service = new Service_t();
+                return Service;
+            }
+        };
+    }
+
+    // Callbacks run on the IO thread, or inline if the request could be answered from a queued write.
+    inline void Readfile(std::filesystem::path Path, Readcallback_t &&Callback)
+    {
+        Internal::Request_t Request{ std::move(Path), {}, false };
+        Request.Readers.push_back(std::move(Callback));
+        Internal::Service_t::getService()->Enqueue(std::move(Request));
+    }
+    inline void Writefile(std::filesystem::path Path, Blob Buffer, Writecallback_t &&Callback)
+    {
+        Internal::Request_t Request{ std::move(Path), std::move(Buffer), true };
+        Request.Writers.push_back(std::move(Callback));
+        Internal::Service_t::getService()->Enqueue(std::move(Request));
+    }
+
+    [[nodiscard]] inline std::future<Blob> Readfile(std::filesystem::path Path)
+    {
+        const auto Promise = std::make_shared<std::promise<Blob>>();
+        Readfile(std::move(Path), [=](Blob &&Content) { Promise->set_value(std::move(Content)); });
+        return Promise->get_future();
+    }
+    inline std::future<bool> Writefile(std::filesystem::path Path, Blob Buffer)
+    {
+        const auto Promise = std::make_shared<std::promise<bool>>();
+        Writefile(std::move(Path), std::move(Buffer), [=](bool Success) { Promise->set_value(Success); });
+        return Promise->get_future();
+    }
+
+    // For small, frequently updated files (e.g. configs), only the latest buffer within the delay is written.
+    inline void Writebehind(std::filesystem::path Path, Blob Buffer, std::chrono::milliseconds Delay = 500ms)
+    {
+        Internal::Service_t::getService()->Enqueue(std::move(Path), std::move(Buffer), nullptr, Delay);
+    }
+
+    // Marks a document as dirty, the serializer runs once on the IO thread when the delay expires.
+    // It needs to synchronize with whoever modifies the state it serializes.
+    inline void Writebehind(std::filesystem::path Path, Serializer_t Serializer, std::chrono::milliseconds Delay = 500ms)
+    {
+        Internal::Service_t::getService()->Enqueue(std::move(Path), {}, std::move(Serializer), Delay);
+    }
+
+    // Blocks until all queued and delayed requests have completed.
+    inline void Flush()
+    {
+        Internal::Service_t::getService()->Flush();
+    }
+
+    // As above, but only for a file or the files in a directory, e.g. before reading them synchronously.
+    inline void Flush(const std::filesystem::path &Scope)
+    {
+        Internal::Service_t::getService()->Flush(Scope);
+    }
+}
@@ -0,0 +1,156 @@
+/*
+    Initial author: Convery (tcn@ayria.se)
+    Started: 2020-11-17
+    License: MIT
+
+    Cached directory listing, only re-read when the OS reports a change in it.
+    Entries are sorted by name for indexed access, lookups and prefix queries.
+
+    FS::Directoryindex_t Saves("./Ayria/Assets/Platformwrapper/480");
+    const auto Snapshot = Saves.get();
+    for (const auto &Entry : Snapshot->Prefix("Slot")) {}
+*/
+
+#pragma once
+#include <Stdinclude.hpp>
+
+#if !defined(_WIN32)
+#include <sys/inotify.h>
+#endif
+
+namespace FS
+{
+    struct Direntry_t
+    {
+        std::string Name;   // Relative to the root, '/' separated.
+        uint64_t Size;
+        int64_t Modified;   // Unix time.
+    };
+
+    struct Dirsnapshot_t
+    {
+        std::vector<Direntry_t> Entries;
+
+        [[nodiscard]] size_t size() const { return Entries.size(); }
+        [[nodiscard]] const Direntry_t *operator[](size_t Index) const
+        {
+            return Index < Entries.size() ? &Entries[Index] : nullptr;
+        }
+
+        [[nodiscard]] const Direntry_t *Find(std::string_view Name) const
+        {
+            const auto Result = std::lower_bound(Entries.begin(), Entries.end(), Name, [](const auto &Entry, const auto &Key) { return Entry.Name < Key; });
+            return Result != Entries.end() && Result->Name == Name ? &*Result : nullptr;
+        }
+        [[nodiscard]] std::span<const Direntry_t> Prefix(std::string_view Prefix) const
+        {
+            const auto Begin = std::lower_bound(Entries.begin(), Entries.end(), Prefix, [](const auto &Entry, const auto &Key) { return Entry.Name < Key; });
+            auto End = Begin;
+            while (End != Entries.end() && End->Name.starts_with(Prefix)) ++End;
+            return { Begin, End };
+        }
+    };
+
+    class Directoryindex_t
+    {
+        std::filesystem::path Root;
+        bool isRecursive;
+
+        std::shared_ptr<const Dirsnapshot_t> Current;
+        std::mutex Lock;
+
+        #if defined(_WIN32)
+        HANDLE Notification{ INVALID_HANDLE_VALUE };
+        #else
+        int Notification{ -1 };
+        bool isWatched{};
+        #endif
+
+        // Drains pending notifications, true if anything changed or nothing is being watched.
+        bool hasChanged()
+        {
+            #if defined(_WIN32)
+                // E.g. the directory does not exist yet.
+                if (Notification == INVALID_HANDLE_VALUE) return true;
+
+                if (WAIT_OBJECT_0 != WaitForSingleObject(Notification, 0)) return false;
+                FindNextChangeNotification(Notification);
+                return true;
+            #else
+                // E.g. the directory does not exist yet.
+                bool Changed{ !isWatched };
+                alignas(inotify_event) char Buffer[4096];
+                while (read(Notification, Buffer, sizeof(Buffer)) > 0) Changed = true;
+                return Changed;
+            #endif
+        }
+
+        bool Watch(const std::filesystem::path &Directory)
+        {
+            #if defined(_WIN32)
+                // A single notification covers the whole tree.
+                if (Notification == INVALID_HANDLE_VALUE && Directory == Root)
+                    Notification = FindFirstChangeNotificationW(Root.c_str(), isRecursive,
+                        FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+                return Notification != INVALID_HANDLE_VALUE;
+            #else
+                // Watches are per directory on Linux, re-adding one is a no-op.
+                return Notification != -1 && -1 != inotify_add_watch(Notification, Directory.c_str(), IN_CREATE | IN_DELETE | IN_MODIFY |
+                                                                     IN_ATTRIB | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF);
+            #endif
+        }
+
+        [[nodiscard]] std::shared_ptr<const Dirsnapshot_t> Rebuild()
+        {
+            auto Snapshot = std::make_shared<Dirsnapshot_t>();
+            std::error_code Error;
+
+            const auto Add = [&](const std::filesystem::directory_entry &File)
+            {
+                if (File.is_directory(Error)) { Watch(File.path()); return; }
+
+                const auto Modified = std::chrono::file_clock::to_sys(File.last_write_time(Error));
+                Snapshot->Entries.push_back({ File.path().lexically_relative(Root).generic_string(), File.file_size(Error),
+                                              std::chrono::duration_cast<std::chrono::seconds>(Modified.time_since_epoch()).count() });
+            };
+
+            #if defined(_WIN32)
+                Watch(Root);
+            #else
+                isWatched = Watch(Root);
+            #endif
+
+            if (isRecursive) for (const auto &File : std::filesystem::recursive_directory_iterator(Root, Error)) Add(File);
+            else for (const auto &File : std::filesystem::directory_iterator(Root, Error)) Add(File);
+
+            std::sort(Snapshot->Entries.begin(), Snapshot->Entries.end(), [](const auto &A, const auto &B) { return A.Name < B.Name; });
+            return Snapshot;
+        }
+
+    public:
+        explicit Directoryindex_t(std::filesystem::path Directory, bool Recursive = false) : Root(std::move(Directory)), isRecursive(Recursive)
+        {
+            #if !defined(_WIN32)
+                Notification = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            #endif
+        }
+        ~Directoryindex_t()
+        {
+            #if defined(_WIN32)
+                if (Notification != INVALID_HANDLE_VALUE) FindCloseChangeNotification(Notification);
+            #else
+                if (Notification != -1) close(Notification);
+            #endif
+        }
+        Directoryindex_t(const Directoryindex_t &) = delete;
+        Directoryindex_t &operator=(const Directoryindex_t &) = delete;
+
+        // Snapshots stay valid while held, even if the directory changes.
+        [[nodiscard]] std::shared_ptr<const Dirsnapshot_t> get()
+        {
+            std::scoped_lock Guard(Lock);
+            if (!Current || hasChanged()) Current = Rebuild();
+            return Current;
+        }
+    };
+}
@@ -45,71 +45,127 @@ namespace FS
         return Code.value() ? 0 : Size;
     }
 
-    namespace Internal
+    // Read-only view of a whole file for the lifetime of the object, nothing is copied.
+    // Sequential access asks the OS to read ahead, e.g. for parsing or scanning the entire file.
+    class Mappedfile
     {
-        template <typename T = uint8_t, typename = std::enable_if_t<sizeof(T) == 1, T>>
-        [[nodiscard]] inline std::basic_string<T> Readfile_large(std::string_view Path, size_t Size)
+        const uint8_t *Data{};
+        size_t Size{};
+
+        void Advise(bool isSequential)
         {
             #if defined(_WIN32)
-                const auto FD = _open(Path.data(), 0x800, 0);
-                if (FD == -1) return {};
-
-                const auto Handle = CreateFileMappingA((HANDLE)_get_osfhandle(FD), NULL,
-                                                       PAGE_READONLY, 0, Size & 0xFFFFFFFF, NULL);
-                if (!Handle) return {};
+                // Windows 8+ only, so resolved at runtime.
+                using Prefetch_t = BOOL (WINAPI *)(HANDLE, ULONG_PTR, void *, ULONG);
+                static const auto Prefetch = (Prefetch_t)GetProcAddress(GetModuleHandleA("kernel32.dll"), "PrefetchVirtualMemory");
 
-                const auto Mapped = MapViewOfFile(Handle, FILE_MAP_COPY | FILE_MAP_READ, 0, 0, Size & 0xFFFFFFFF);
-                if (!Mapped) { CloseHandle(Handle); _close(FD); return {}; }
-
-                std::basic_string<T> Filebuffer(Size, 0);
-                std::memcpy(Filebuffer.data(), Mapped, Size);
-
-                UnmapViewOfFile(Mapped);
-                CloseHandle(Handle);
-                _close(FD);
+                struct { const void *Address; size_t Size; } Entry{ Data, Size };
+                if (isSequential && Prefetch) Prefetch(GetCurrentProcess(), 1, &Entry, 0);
             #else
+                if (!isSequential) { madvise((void *)Data, Size, MADV_RANDOM); return; }
 
-                const auto FD = open(Path.data(), 0, 0);
-                if (FD == -1) return {};
+                madvise((void *)Data, Size, MADV_SEQUENTIAL);
+                madvise((void *)Data, Size, MADV_WILLNEED);
+            #endif
+        }
 
-                const auto Mapped = (uint8_t *)mmap(NULL, Size, PROT_READ, MAP_PRIVATE, FD, 0);
+        #if defined(_WIN32)
+        void Map(HANDLE Filehandle, bool isSequential)
+        {
+            if (Filehandle == INVALID_HANDLE_VALUE) return;
 
-                std::basic_string<T> Filebuffer(Size, 0);
-                std::memcpy(Filebuffer.data(), Mapped, Size);
+            LARGE_INTEGER Filesize{};
+            if (!GetFileSizeEx(Filehandle, &Filesize) || !Filesize.QuadPart) { CloseHandle(Filehandle); return; }
 
-                munmap((void *)Mapped, Size);
-                close(FD);
-            #endif
+            // The view keeps both the section and the file alive.
+            if (const auto Mapping = CreateFileMappingA(Filehandle, NULL, PAGE_READONLY, 0, 0, NULL))
+            {
+                Data = (const uint8_t *)MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+                CloseHandle(Mapping);
+            }
+            CloseHandle(Filehandle);
 
-            return Filebuffer;
+            if (Data) { Size = size_t(Filesize.QuadPart); Advise(isSequential); }
         }
-        template <typename T = uint8_t, typename = std::enable_if_t<sizeof(T) == 1, T>>
-        [[nodiscard]] inline std::basic_string<T> Readfile_large(std::wstring_view Path, size_t Size)
+        #else
+        void Map(int FD, bool isSequential)
         {
-            #if !defined(_WIN32)
-                return Readfile_large(toNarrow(Path), Size);
-            #else
-                const auto FD = _wopen(Path.data(), 0x800, 0);
-                if (FD == -1) return {};
+            if (FD == -1) return;
 
-                const auto Handle = CreateFileMappingA((HANDLE)_get_osfhandle(FD), NULL,
-                                                       PAGE_READONLY, 0, Size & 0xFFFFFFFF, NULL);
-                if (!Handle) return {};
+            struct stat Buffer;
+            if (fstat(FD, &Buffer) == -1 || Buffer.st_size <= 0) { close(FD); return; }
 
-                const auto Mapped = MapViewOfFile(Handle, FILE_MAP_COPY | FILE_MAP_READ, 0, 0, Size & 0xFFFFFFFF);
-                if (!Mapped) { CloseHandle(Handle); _close(FD); return {}; }
+            const auto Mapped = mmap(NULL, size_t(Buffer.st_size), PROT_READ, MAP_PRIVATE, FD, 0);
+            close(FD);
 
-                std::basic_string<T> Filebuffer(Size, 0);
-                std::memcpy(Filebuffer.data(), Mapped, Size);
+            if (Mapped != MAP_FAILED) { Data = (const uint8_t *)Mapped; Size = size_t(Buffer.st_size); Advise(isSequential); }
+        }
+        #endif
+
+    public:
+        [[nodiscard]] const uint8_t *data() const { return Data; }
+        [[nodiscard]] size_t size() const { return Size; }
+        [[nodiscard]] bool empty() const { return !Size; }
+        explicit operator bool() const { return !!Size; }
+
+        [[nodiscard]] Blob_view asBlob() const { return { Data, Size }; }
+        [[nodiscard]] std::string_view asString() const { return { (const char *)Data, Size }; }
 
-                UnmapViewOfFile(Mapped);
-                CloseHandle(Handle);
-                _close(FD);
+        explicit Mappedfile(std::string_view Path, bool isSequential = true)
+        {
+            #if defined(_WIN32)
+                Map(CreateFileA(Path.data(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                isSequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS, NULL), isSequential);
+            #else
+                Map(open(Path.data(), O_RDONLY), isSequential);
+            #endif
+        }
+        explicit Mappedfile(std::wstring_view Path, bool isSequential = true)
+        {
+            #if defined(_WIN32)
+                Map(CreateFileW(Path.data(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                isSequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS, NULL), isSequential);
+            #else
+                Map(open(toNarrow(Path).c_str(), O_RDONLY), isSequential);
+            #endif
+        }
+        ~Mappedfile()
+        {
+            if (!Data) return;
 
-                return Filebuffer;
+            #if defined(_WIN32)
+                UnmapViewOfFile(Data);
+            #else
+                munmap((void *)Data, Size);
             #endif
         }
 
+        Mappedfile(Mappedfile &&Right) noexcept : Data(std::exchange(Right.Data, nullptr)), Size(std::exchange(Right.Size, 0)) {}
+        Mappedfile &operator=(Mappedfile &&Right) noexcept
+        {
+            std::swap(Data, Right.Data);
+            std::swap(Size, Right.Size);
+            return *this;
+        }
+        Mappedfile(const Mappedfile &) = delete;
+        Mappedfile &operator=(const Mappedfile &) = delete;
+    };
+
+    namespace Internal
+    {
+        template <typename T = uint8_t, typename = std::enable_if_t<sizeof(T) == 1, T>>
+        [[nodiscard]] inline std::basic_string<T> Readfile_large(std::string_view Path, size_t)
+        {
+            const Mappedfile View(Path);
+            return std::basic_string<T>((const T *)View.data(), View.size());
+        }
+        template <typename T = uint8_t, typename = std::enable_if_t<sizeof(T) == 1, T>>
+        [[nodiscard]] inline std::basic_string<T> Readfile_large(std::wstring_view Path, size_t)
+        {
+            const Mappedfile View(Path);
+            return std::basic_string<T>((const T *)View.data(), View.size());
+        }
+
         template <typename T = uint8_t, typename = std::enable_if_t<sizeof(T) == 1, T>>
         [[nodiscard]] inline std::basic_string<T> Readfile_small(std::string_view Path, size_t Size)
         {
@@ -187,6 +243,38 @@ namespace FS
     inline bool Writefile(std::wstring_view Path, const std::basic_string<T> &Buffer)
     { return Writefile(Path, std::basic_string_view<T>(Buffer)); }
 
+    // Written to a temporary file that replaces the target, so a crash never leaves a partial file.
+    template<typename T>
+    inline bool Writefileatomic(const std::filesystem::path &Path, std::basic_string_view<T> Buffer)
+    {
+        auto Temporary = Path; Temporary += ".tmp";
+        std::error_code Error;
+
+        #if defined(_WIN32)
+        std::FILE *Filehandle = _wfopen(Temporary.c_str(), L"wb");
+        #else
+        std::FILE *Filehandle = std::fopen(Temporary.c_str(), "wb");
+        #endif
+        if (!Filehandle) return false;
+
+        // The data needs to be on disk before the rename is.
+        bool Result = Buffer.empty() || 1 == std::fwrite(Buffer.data(), Buffer.size() * sizeof(T), 1, Filehandle);
+        Result &= 0 == std::fflush(Filehandle);
+        #if defined(_WIN32)
+        Result &= 0 == _commit(_fileno(Filehandle));
+        #else
+        Result &= 0 == fsync(fileno(Filehandle));
+        #endif
+        std::fclose(Filehandle);
+
+        if (Result) std::filesystem::rename(Temporary, Path, Error);
+        if (Result &= !Error; !Result) std::filesystem::remove(Temporary, Error);
+        return Result;
+    }
+    template<typename T>
+    inline bool Writefileatomic(const std::filesystem::path &Path, const std::basic_string<T> &Buffer)
+    { return Writefileatomic(Path, std::basic_string_view<T>(Buffer)); }
+
     // Directory iteration, filename if not recursive; else full path.
     [[nodiscard]] inline std::vector<std::string> Findfiles(std::string Directorypath, std::string_view Criteria, bool Recursive = false)
     {
@@ -0,0 +1,428 @@
+/*
+    Initial author: Convery (tcn@ayria.se)
+    Started: 2020-11-18
+    License: MIT
+
+    Embedded key-value store, an append-only log mapped into memory with a hash-index over it.
+    Records are CRC-checked, so a torn write at the tail is dropped when the file is next opened.
+    Overwritten and erased records are reclaimed by compaction once they outweigh the live ones.
+    One process at a time owns the file, others get a private in-memory copy, see isPrivate().
+
+    Kvstore_t Store("./Ayria/Storage.kv");
+    Store.Put("Relations/1234", Bytebuffer(...).asBlob());
+    const auto Flags = Store.Get<uint32_t>("Settings/Flags");
+*/
+
+#pragma once
+#include <Stdinclude.hpp>
+#include "Filesystem.hpp"
+#include <optional>
+
+class Kvstore_t
+{
+    static constexpr uint32_t Magic = Hash::FNV1_32("Kvstore_v1");
+    static constexpr uint32_t Tombstone = UINT32_MAX;
+    static constexpr size_t Minimumcapacity = 64 * 1024;
+
+    struct Fileheader_t { uint32_t Magic, Reserved; uint64_t Used; };
+    struct Recordheader_t { uint32_t Checksum, Keysize, Valuesize; };
+    struct Location_t { uint64_t Offset; uint32_t Valuesize; };
+
+    std::unordered_map<std::string, Location_t> Index;
+    uint64_t Livebytes{}, Deadbytes{};
+    std::filesystem::path Path;
+    mutable std::mutex Lock;
+
+    uint8_t *Mapped{};
+    size_t Capacity{};
+    bool isValid{};
+
+    // Used instead of the file when another process holds the lock.
+    Blob Memory;
+    bool isVolatile{};
+
+    #if defined(_WIN32)
+    HANDLE Filehandle{ INVALID_HANDLE_VALUE };
+    #else
+    int Filehandle{ -1 };
+    #endif
+
+    [[nodiscard]] Fileheader_t *Header() const { return (Fileheader_t *)Mapped; }
+    [[nodiscard]] static uint64_t Recordsize(uint32_t Keysize, uint32_t Valuesize)
+    {
+        return sizeof(Recordheader_t) + Keysize + (Valuesize == Tombstone ? 0 : Valuesize);
+    }
+
+    // Maps (or remaps) the file with at least the requested size, the file grows to match.
+    bool Map(size_t Size)
+    {
+        if (Mapped && !isVolatile)
+        {
+            #if defined(_WIN32)
+                UnmapViewOfFile(Mapped);
+            #else
+                munmap(Mapped, Capacity);
+            #endif
+            Mapped = nullptr;
+        }
+
+        Capacity = std::max(Size, Minimumcapacity);
+
+        if (isVolatile)
+        {
+            if (Memory.size() < Capacity) Memory.resize(Capacity);
+            Mapped = Memory.data();
+            return true;
+        }
+
+        #if defined(_WIN32)
+            const auto Mapping = CreateFileMappingW(Filehandle, NULL, PAGE_READWRITE, DWORD(uint64_t(Capacity) >> 32), DWORD(Capacity), NULL);
+            if (!Mapping) return false;
+
+            Mapped = (uint8_t *)MapViewOfFile(Mapping, FILE_MAP_WRITE, 0, 0, Capacity);
+            CloseHandle(Mapping);
+        #else
+            struct stat Buffer;
+            if (fstat(Filehandle, &Buffer) == -1) return false;
+            if (size_t(Buffer.st_size) < Capacity && ftruncate(Filehandle, off_t(Capacity)) == -1) return false;
+
+            Mapped = (uint8_t *)mmap(NULL, Capacity, PROT_READ | PROT_WRITE, MAP_SHARED, Filehandle, 0);
+            if (Mapped == MAP_FAILED) Mapped = nullptr;
+        #endif
+
+        return !!Mapped;
+    }
+    // Also drops the index, as it refers to the mapping.
+    void Unmap()
+    {
+        Index.clear();
+        Livebytes = Deadbytes = 0;
+
+        if (Mapped && !isVolatile)
+        {
+            #if defined(_WIN32)
+                UnmapViewOfFile(Mapped);
+            #else
+                munmap(Mapped, Capacity);
+            #endif
+        }
+        Mapped = nullptr;
+
+        #if defined(_WIN32)
+            if (Filehandle != INVALID_HANDLE_VALUE) CloseHandle(Filehandle);
+            Filehandle = INVALID_HANDLE_VALUE;
+        #else
+            if (Filehandle != -1) close(Filehandle);
+            Filehandle = -1;
+        #endif
+    }
+
+    // Takes the file if no other process has it, else reads a copy of it into memory.
+    bool Openfile(size_t &Size)
+    {
+        #if defined(_WIN32)
+            Filehandle = CreateFileW(Path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+            if (Filehandle == INVALID_HANDLE_VALUE) return false;
+
+            LARGE_INTEGER Filesize{};
+            if (!GetFileSizeEx(Filehandle, &Filesize)) return false;
+            Size = size_t(Filesize.QuadPart);
+
+            // Byte-range locks are mandatory on Windows, so lock a byte that is never read.
+            OVERLAPPED Lockrange{}; Lockrange.Offset = Lockrange.OffsetHigh = 0xFFFFFFFF;
+            isVolatile = !LockFileEx(Filehandle, LOCKFILE_EXCLUSIVE_LOCK | LOCKFILE_FAIL_IMMEDIATELY, 0, 1, 0, &Lockrange);
+            if (!isVolatile) return true;
+
+            DWORD Read{};
+            Memory.resize(Size);
+            const auto Result = !Size || (ReadFile(Filehandle, Memory.data(), DWORD(Size), &Read, NULL) && Read == Size);
+        #else
+            Filehandle = open(Path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+            if (Filehandle == -1) return false;
+
+            struct stat Buffer;
+            if (fstat(Filehandle, &Buffer) == -1) return false;
+            Size = size_t(Buffer.st_size);
+
+            isVolatile = -1 == flock(Filehandle, LOCK_EX | LOCK_NB);
+            if (!isVolatile) return true;
+
+            Memory.resize(Size);
+            const auto Result = !Size || pread(Filehandle, Memory.data(), Size, 0) == ssize_t(Size);
+        #endif
+
+        // The copy no longer needs the file.
+        Unmap();
+        return Result;
+    }
+
+    // Checks the header before the file is grown to the mapping size, so other files are left untouched.
+    bool isOurs(size_t Size) const
+    {
+        if (Size == 0) return true;
+        if (Size < sizeof(Fileheader_t)) return false;
+
+        Fileheader_t Fileheader{};
+        if (isVolatile) std::memcpy(&Fileheader, Memory.data(), sizeof(Fileheader));
+        else
+        {
+            #if defined(_WIN32)
+                DWORD Read{};
+                OVERLAPPED Start{};
+                if (!ReadFile(Filehandle, &Fileheader, sizeof(Fileheader), &Read, &Start) || Read != sizeof(Fileheader)) return false;
+            #else
+                if (pread(Filehandle, &Fileheader, sizeof(Fileheader), 0) != ssize_t(sizeof(Fileheader))) return false;
+            #endif
+        }
+
+        return Fileheader.Magic == Magic && Fileheader.Used <= Size;
+    }
+
+    bool Open()
+    {
+        size_t Size{};
+        if (!Openfile(Size) || !isOurs(Size) || !Map(Size) || !Buildindex(Size == 0))
+        {
+            Unmap();
+            return false;
+        }
+
+        return true;
+    }
+
+    // Rebuilds the index from the log, stopping at the first record that fails validation.
+    bool Buildindex(bool isNew)
+    {
+        if (isNew) *Header() = { Magic, 0, sizeof(Fileheader_t) };
+        if (Header()->Magic != Magic || Header()->Used > Capacity) return false;
+
+        Index.clear();
+        Livebytes = Deadbytes = 0;
+
+        auto Offset = uint64_t(sizeof(Fileheader_t));
+        while (Offset + sizeof(Recordheader_t) <= Header()->Used)
+        {
+            Recordheader_t Record;
+            std::memcpy(&Record, Mapped + Offset, sizeof(Record));
+
+            const auto Length = Recordsize(Record.Keysize, Record.Valuesize);
+            if (Offset + Length > Header()->Used) break;
+            if (Record.Checksum != Hash::CRC32B((const char *)Mapped + Offset + sizeof(uint32_t), uint32_t(Length - sizeof(uint32_t)))) break;
+
+            const std::string Key((const char *)Mapped + Offset + sizeof(Record), Record.Keysize);
+            if (const auto Previous = Index.find(Key); Previous != Index.end())
+            {
+                const auto Oldsize = Recordsize(Record.Keysize, Previous->second.Valuesize);
+                Livebytes -= Oldsize;
+                Deadbytes += Oldsize;
+            }
+
+            if (Record.Valuesize == Tombstone)
+            {
+                Index.erase(Key);
+                Deadbytes += Length;
+            }
+            else
+            {
+                Index[Key] = { Offset + sizeof(Record) + Record.Keysize, Record.Valuesize };
+                Livebytes += Length;
+            }
+
+            Offset += Length;
+        }
+
+        // Anything after the last valid record is a torn write.
+        Header()->Used = Offset;
+        return true;
+    }
+
+    // Lock held.
+    bool Append(std::string_view Key, const void *Value, uint32_t Valuesize)
+    {
+        if (!isValid) return false;
+
+        const auto Size = Recordsize(uint32_t(Key.size()), Valuesize);
+        const auto Offset = Header()->Used;
+
+        if (Offset + Size > Capacity)
+        {
+            if (!Map(std::max(size_t(Offset + Size), Capacity * 2))) { Unmap(); isValid = false; return false; }
+        }
+
+        Recordheader_t Record{ 0, uint32_t(Key.size()), Valuesize };
+        std::memcpy(Mapped + Offset, &Record, sizeof(Record));
+        std::memcpy(Mapped + Offset + sizeof(Record), Key.data(), Key.size());
+        if (Valuesize != Tombstone) std::memcpy(Mapped + Offset + sizeof(Record) + Key.size(), Value, Valuesize);
+
+        Record.Checksum = Hash::CRC32B((const char *)Mapped + Offset + sizeof(uint32_t), uint32_t(Size - sizeof(uint32_t)));
+        std::memcpy(Mapped + Offset, &Record.Checksum, sizeof(uint32_t));
+
+        // The record only exists once the header covers it.
+        Header()->Used = Offset + Size;
+
+        auto Entry = Index.find(std::string(Key));
+        if (Entry != Index.end())
+        {
+            const auto Oldsize = Recordsize(uint32_t(Key.size()), Entry->second.Valuesize);
+            Livebytes -= Oldsize;
+            Deadbytes += Oldsize;
+        }
+
+        if (Valuesize == Tombstone)
+        {
+            if (Entry != Index.end()) Index.erase(Entry);
+            Deadbytes += Size;
+        }
+        else
+        {
+            if (Entry == Index.end()) Entry = Index.emplace(std::string(Key), Location_t{}).first;
+            Entry->second = { Offset + sizeof(Record) + Key.size(), Valuesize };
+            Livebytes += Size;
+        }
+
+        // Reclaim space once most of the file is garbage.
+        if (Deadbytes > Minimumcapacity && Deadbytes > Livebytes) Compactlocked();
+        return true;
+    }
+
+    // Lock held, rewrites the live records to a new file that atomically replaces the old one.
+    bool Compactlocked()
+    {
+        if (!isValid) return false;
+
+        Blob Buffer;
+        Buffer.reserve(sizeof(Fileheader_t) + Livebytes);
+        Buffer.resize(sizeof(Fileheader_t));
+
+        for (const auto &[Key, Location] : Index)
+        {
+            const auto Start = Location.Offset - Key.size() - sizeof(Recordheader_t);
+            Buffer.append(Mapped + Start, Recordsize(uint32_t(Key.size()), Location.Valuesize));
+        }
+
+        const Fileheader_t Fileheader{ Magic, 0, Buffer.size() };
+        std::memcpy(Buffer.data(), &Fileheader, sizeof(Fileheader));
+
+        // The old file can not be replaced while mapped on Windows.
+        Unmap();
+
+        if (isVolatile)
+        {
+            Memory = std::move(Buffer);
+            isValid = Map(Memory.size()) && Buildindex(false);
+            return isValid;
+        }
+
+        const auto Result = FS::Writefileatomic(Path, Buffer);
+        isValid = Open();
+        return Result && isValid;
+    }
+
+public:
+    explicit Kvstore_t(std::filesystem::path Filepath) : Path(std::move(Filepath))
+    {
+        isValid = Open();
+    }
+    ~Kvstore_t()
+    {
+        Flush();
+        Unmap();
+    }
+    Kvstore_t(const Kvstore_t &) = delete;
+    Kvstore_t &operator=(const Kvstore_t &) = delete;
+
+    [[nodiscard]] bool Valid() const { return isValid; }
+    [[nodiscard]] bool isPrivate() const { return isVolatile; }
+    [[nodiscard]] size_t size() const { std::scoped_lock Guard(Lock); return Index.size(); }
+
+    bool Put(std::string_view Key, Blob_view Value)
+    {
+        assert(Value.size() < Tombstone);
+
+        std::scoped_lock Guard(Lock);
+        return Append(Key, Value.data(), uint32_t(Value.size()));
+    }
+    bool Erase(std::string_view Key)
+    {
+        std::scoped_lock Guard(Lock);
+        if (!Index.contains(std::string(Key))) return false;
+        return Append(Key, nullptr, Tombstone);
+    }
+
+    [[nodiscard]] bool contains(std::string_view Key) const
+    {
+        std::scoped_lock Guard(Lock);
+        return Index.contains(std::string(Key));
+    }
+    [[nodiscard]] std::optional<Blob> Get(std::string_view Key) const
+    {
+        std::scoped_lock Guard(Lock);
+        const auto Entry = Index.find(std::string(Key));
+        if (Entry == Index.end()) return {};
+
+        return Blob(Mapped + Entry->second.Offset, Entry->second.Valuesize);
+    }
+
+    // Strings and containers are stored as their elements, other trivial types as their bytes.
+    template <typename T> bool Put(std::string_view Key, const T &Value)
+    {
+        if constexpr (std::is_array_v<T>) return Put(Key, std::basic_string_view<std::remove_extent_t<T>>(Value));
+        else if constexpr (requires { Value.data(); Value.size(); }) return Put(Key, Blob_view((const uint8_t *)Value.data(), Value.size() * sizeof(*Value.data())));
+        else
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Serialize the type first, e.g. with Bytebuffer.");
+            return Put(Key, Blob_view((const uint8_t *)&Value, sizeof(T)));
+        }
+    }
+    template <typename T> [[nodiscard]] std::optional<T> Get(std::string_view Key) const
+    {
+        const auto Value = Get(Key);
+        if (!Value) return {};
+
+        if constexpr (requires (T Container) { Container.data(); Container.size(); })
+        {
+            using Element_t = typename T::value_type;
+            return T((const Element_t *)Value->data(), (const Element_t *)Value->data() + Value->size() / sizeof(Element_t));
+        }
+        else
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Deserialize the type after, e.g. with Bytebuffer.");
+            if (Value->size() != sizeof(T)) return {};
+
+            T Result;
+            std::memcpy(&Result, Value->data(), sizeof(T));
+            return Result;
+        }
+    }
+
+    // Unordered, the views are only valid during the callback which must not modify the store.
+    void Scan(std::string_view Prefix, const std::function<void(std::string_view Key, Blob_view Value)> &Callback) const
+    {
+        std::scoped_lock Guard(Lock);
+        for (const auto &[Key, Location] : Index)
+        {
+            if (Key.starts_with(Prefix))
+                Callback(Key, Blob_view(Mapped + Location.Offset, Location.Valuesize));
+        }
+    }
+
+    bool Compact()
+    {
+        std::scoped_lock Guard(Lock);
+        return Compactlocked();
+    }
+
+    // The OS writes the pages back eventually, this forces it.
+    void Flush()
+    {
+        std::scoped_lock Guard(Lock);
+        if (!Mapped || isVolatile) return;
+
+        #if defined(_WIN32)
+            FlushViewOfFile(Mapped, 0);
+            FlushFileBuffers(Filehandle);
+        #else
+            msync(Mapped, Capacity, MS_SYNC);
+        #endif
+    }
+};